@@ -0,0 +1,183 @@
+#pragma once
+
+/**
+ * \file
+ * \brief ENC Chart Cache
+ *
+ * Byte budgeted LRU cache of opened ENC(S-57) chart datasets, so charts used
+ * by neighboring tiles are not reopened and reparsed for every request.
+ */
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include <gdal_priv.h>
+#include <encdata/chart_metadata.h>
+
+namespace encdata
+{
+
+/// LRU cache of opened chart datasets
+class chart_cache
+{
+public:
+
+    /// Cache counters
+    struct stats
+    {
+        /// Opens satisfied from cache
+        uint64_t hits;
+
+        /// Opens requiring a new dataset
+        uint64_t misses;
+
+        /// Datasets closed to stay within budget
+        uint64_t evictions;
+
+        /// Idle datasets in cache
+        std::size_t entries;
+
+        /// Estimated size of idle datasets (bytes)
+        std::size_t bytes;
+    };
+
+private:
+
+    /// Cached dataset
+    struct entry
+    {
+        /// Chart identity (path and fingerprint)
+        std::string key;
+
+        /// Opened dataset
+        std::unique_ptr<GDALDataset> ds;
+
+        /// Estimated size (bytes)
+        std::size_t bytes;
+    };
+
+public:
+
+    /**
+     * Exclusive Dataset Lease
+     *
+     * Datasets are not safe for concurrent use, so each is leased to one
+     * caller at a time, and returned to the cache when the lease ends.
+     */
+    class handle
+    {
+    public:
+
+        /**
+         * Constructor
+         *
+         * \param[in] cache Owning cache
+         * \param[in] item Leased dataset
+         */
+        handle(chart_cache *cache, entry &&item);
+
+        /**
+         * Destructor (returns dataset to cache)
+         */
+        ~handle();
+
+        handle(handle &&other) = default;
+        handle(const handle &) = delete;
+        handle &operator=(const handle &) = delete;
+
+        /**
+         * Get Dataset
+         *
+         * \return Leased dataset
+         */
+        GDALDataset *get() const;
+
+    private:
+
+        /// Owning cache (null once released)
+        chart_cache *cache_;
+
+        /// Leased dataset
+        entry item_;
+    };
+
+    /**
+     * Constructor
+     *
+     * \param[in] budget Size budget for idle datasets (bytes)
+     */
+    chart_cache(std::size_t budget = 256UL << 20);
+
+    /**
+     * Set Size Budget
+     *
+     * \param[in] budget Size budget for idle datasets (bytes)
+     */
+    void set_budget(std::size_t budget);
+
+    /**
+     * Open Chart Dataset
+     *
+     * \param[in] chart Chart to open
+     * \return Exclusive lease of dataset
+     */
+    handle open(const chart_metadata &chart);
+
+    /**
+     * Close All Idle Datasets
+     */
+    void clear();
+
+    /**
+     * Get Cache Counters
+     *
+     * \return Current counters
+     */
+    stats get_stats() const;
+
+private:
+
+    /**
+     * Return Dataset to Cache
+     *
+     * \param[in] item Dataset to return
+     */
+    void release(entry &&item);
+
+    /**
+     * Evict Datasets Over Budget (mutex held)
+     *
+     * \param[out] evicted Evicted datasets, to close once unlocked
+     */
+    void evict(std::list<entry> &evicted);
+
+    /// Protects cache contents
+    mutable std::mutex mutex_;
+
+    /// Idle datasets, most recently used first
+    std::list<entry> lru_;
+
+    /// Idle datasets by chart identity
+    std::unordered_multimap<std::string, std::list<entry>::iterator> idle_;
+
+    /// Size budget for idle datasets (bytes)
+    std::size_t budget_;
+
+    /// Estimated size of idle datasets (bytes)
+    std::size_t bytes_;
+
+    /// Opens satisfied from cache
+    std::atomic<uint64_t> hits_;
+
+    /// Opens requiring a new dataset
+    std::atomic<uint64_t> misses_;
+
+    /// Datasets closed to stay within budget
+    std::atomic<uint64_t> evictions_;
+};
+
+}; // ~namespace encdata
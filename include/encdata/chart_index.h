@@ -0,0 +1,114 @@
+#pragma once
+
+/**
+ * \file
+ * \brief ENC Chart Index
+ *
+ * Packed (STR bulk loaded) R-tree of chart coverage bounds, used to quickly
+ * select charts for a bounding box and minimum compilation scale.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <ogr_core.h>
+
+namespace encdata
+{
+
+/// Spatial index of chart bounding boxes
+class chart_index
+{
+public:
+
+    /// Indexed chart
+    struct entry
+    {
+        /// Bounding box (deg)
+        OGREnvelope bbox;
+
+        /// Compilation of scale (DSPM CSCL)
+        int scale;
+    };
+
+    /**
+     * Build Index
+     *
+     * Entries are expected to be presorted in ascending scale order (most
+     * detailed first), as query results are returned in entry order.
+     *
+     * \param[in] entries Charts to index
+     */
+    void build(const std::vector<entry> &entries);
+
+    /**
+     * Clear Index
+     */
+    void clear();
+
+    /**
+     * Query Index
+     *
+     * Finds all charts intersecting the bounding box with a compilation scale
+     * of at least scale_min. Results are entry indices in ascending order,
+     * which is also most detailed first. No allocation is performed if the
+     * results vector already has sufficient capacity.
+     *
+     * \param[out] results Matching entry indices
+     * \param[in] bbox Query bounding box (deg)
+     * \param[in] scale_min Minimum data compilation scale
+     */
+    void query(std::vector<std::size_t> &results, const OGREnvelope &bbox,
+               int scale_min) const;
+
+    /**
+     * Get Indexed Entry Count
+     *
+     * \return Number of indexed charts
+     */
+    std::size_t size() const;
+
+private:
+
+    /// Maximum children per node
+    static constexpr std::size_t fanout = 16;
+
+    /// Tree node
+    struct node
+    {
+        /// Bounding box of all children (deg)
+        OGREnvelope bbox;
+
+        /// Largest compilation scale of all children
+        int scale_max;
+
+        /// Index of first child link
+        uint32_t first;
+
+        /// Number of children
+        uint32_t count;
+
+        /// Children are entries, not nodes
+        bool leaf;
+    };
+
+    /**
+     * Pack One Tree Level
+     *
+     * \param[in] items Item indices to pack (sorted in place)
+     * \param[in] leaf Items are entries, not nodes
+     * \return Indices of created nodes
+     */
+    std::vector<uint32_t> pack(std::vector<uint32_t> &items, bool leaf);
+
+    /// Tree nodes (root is last)
+    std::vector<node> nodes_;
+
+    /// Child links (node indices, or entry indices for leaves)
+    std::vector<uint32_t> links_;
+
+    /// Indexed entries
+    std::vector<entry> entries_;
+};
+
+}; // ~namespace encdata
@@ -0,0 +1,53 @@
+#pragma once
+
+/**
+ * \file
+ * \brief ENC Chart Metadata
+ *
+ * Summary information kept for each indexed ENC(S-57) chart, used for chart
+ * selection without opening the chart itself.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <filesystem>
+#include <ogr_core.h>
+
+namespace encdata
+{
+
+/// Per chart metadata
+struct chart_metadata
+{
+    /// Path to data file
+    std::filesystem::path path;
+
+    /// Compilation of scale (DSPM CSCL)
+    int scale;
+
+    /// Bounding box (deg)
+    OGREnvelope bbox;
+
+    /// Bounding box of each coverage (M_COVR) polygon (deg)
+    std::vector<OGREnvelope> coverage;
+
+    /// Simplified coverage polygon, never smaller than actual coverage (WKB)
+    std::vector<unsigned char> coverage_wkb;
+
+    /// Total size of chart and update files (bytes)
+    uint64_t file_size{0};
+
+    /// Latest modification time of chart and update files (ns)
+    int64_t file_time{0};
+
+    /// Edition number (DSID EDTN)
+    int edition{0};
+
+    /// Update number (DSID UPDN)
+    int update{0};
+
+    /// Version of chart store built from this chart (0 if none)
+    uint32_t store_version{0};
+};
+
+}; // ~namespace encdata
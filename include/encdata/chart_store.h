@@ -0,0 +1,225 @@
+#pragma once
+
+/**
+ * \file
+ * \brief ENC Chart Store
+ *
+ * Compact, memory mapped, columnar copy of an ENC(S-57) chart. Each layer
+ * keeps per-feature bounding boxes, coordinates as contiguous arrays, and
+ * numeric attributes only (all that styles can use for cutoffs), so data
+ * can be extracted without going through the GDAL S57 driver. Line and area
+ * layers are also kept simplified for a few scale bands, so small scale
+ * tiles need not handle full resolution geometry.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <gdal_priv.h>
+#include <ogrsf_frmts.h>
+#include <encdata/chart_metadata.h>
+#include <encdata/geometry_parts.h>
+#include <encdata/mapped_file.h>
+
+namespace encdata
+{
+
+/// Memory mapped chart store
+class chart_store
+{
+public:
+
+    /// File format version
+    static constexpr uint32_t version = 3;
+
+    /// Number of geometry generalization bands (band 0 is full resolution)
+    static constexpr std::size_t band_count = 4;
+
+    /**
+     * Get Band Minimum Scale
+     *
+     * \param[in] band Generalization band
+     * \return Smallest presentation scale band is used for
+     */
+    static int band_scale(std::size_t band);
+
+    /**
+     * Get Band Simplification Tolerance
+     *
+     * A quarter of a display pixel at the band's minimum scale. Features are
+     * simplified one at a time, so edges shared by neighbouring areas may
+     * move apart by up to twice this, which must stay under a pixel to not
+     * show as slivers or gaps.
+     *
+     * \param[in] band Generalization band
+     * \return Simplification tolerance (deg)
+     */
+    static double band_tolerance(std::size_t band);
+
+    /// Per feature record (on disk)
+    struct feature
+    {
+        /// Bounding box (MinX, MaxX, MinY, MaxY)
+        double bbox[4];
+
+        /// Original OGR geometry type
+        uint32_t geom_type;
+
+        /// First geometry part
+        uint32_t part_first;
+
+        /// Number of geometry parts
+        uint32_t part_count;
+
+        /// Padding
+        uint32_t reserved;
+    };
+
+    /// Geometry part (on disk)
+    struct part
+    {
+        /// First coordinate
+        uint32_t coord_first;
+
+        /// Number of coordinates
+        uint32_t coord_count;
+
+        /// Part kind
+        uint32_t kind;
+
+        /// Padding
+        uint32_t reserved;
+    };
+
+    /// View of one stored layer
+    struct layer
+    {
+        /// Layer name (S57 object class)
+        std::string name;
+
+        /// Generalization band (0 is full resolution)
+        std::size_t band;
+
+        /// Number of features
+        std::size_t feature_count;
+
+        /// Feature records
+        const feature *features;
+
+        /// Geometry parts
+        const part *parts;
+
+        /// Coordinate arrays (z is null for 2D layers)
+        const double *x, *y, *z;
+
+        /// Numeric attribute names
+        std::vector<std::string> attr_names;
+
+        /// Attribute values, by attribute then feature (NaN if unset)
+        const double *attr_values;
+
+        /**
+         * Get Feature Bounding Box
+         *
+         * \param[in] idx Feature index
+         * \return Bounding box (deg)
+         */
+        OGREnvelope bbox(std::size_t idx) const;
+
+        /**
+         * Get Attribute Value
+         *
+         * \param[in] attr Attribute index
+         * \param[in] idx Feature index
+         * \return Attribute value (NaN if unset)
+         */
+        double attr(std::size_t attr, std::size_t idx) const;
+
+        /**
+         * Find Attribute
+         *
+         * \param[in] name Attribute name
+         * \return Attribute index, or -1 if not present
+         */
+        int find_attr(const char *name) const;
+
+        /**
+         * Build Feature Geometry
+         *
+         * \param[in] idx Feature index
+         * \return New OGR geometry
+         */
+        std::unique_ptr<OGRGeometry> geometry(std::size_t idx) const;
+    };
+
+    /**
+     * Open Chart Store
+     *
+     * \param[in] path Path to store file
+     * \return False if missing, invalid, or wrong version
+     */
+    bool open(const std::filesystem::path &path);
+
+    /**
+     * Check Store Matches Chart
+     *
+     * \param[in] chart Chart metadata
+     * \return True if store was built from this version of chart
+     */
+    bool matches(const chart_metadata &chart) const;
+
+    /**
+     * Find Layer
+     *
+     * Picks the most generalized band suitable for the presentation scale,
+     * falling back to less generalized bands where one was not stored.
+     *
+     * \param[in] name Layer name (S57 object class)
+     * \param[in] scale_min Minimum presentation scale (0 = full resolution)
+     * \return Layer view, or nullptr if not present
+     */
+    const layer *find_layer(const std::string &name, int scale_min = 0) const;
+
+    /**
+     * Check Store File Is Current
+     *
+     * Only the file header is read.
+     *
+     * \param[in] path Path to store file
+     * \param[in] chart Chart metadata
+     * \return True if file has current version, and matches chart
+     */
+    static bool is_current(const std::filesystem::path &path,
+                           const chart_metadata &chart);
+
+    /**
+     * Write Chart Store
+     *
+     * Written to a temporary file, then atomically renamed into place.
+     *
+     * \param[in] path Path to store file
+     * \param[in] chart Chart metadata (for fingerprint)
+     * \param[in] ds Opened chart dataset
+     * \return False on failure
+     */
+    static bool write(const std::filesystem::path &path,
+                      const chart_metadata &chart, GDALDataset *ds);
+
+private:
+
+    /// Mapped file
+    mapped_file file_;
+
+    /// Source chart size (bytes)
+    uint64_t file_size_;
+
+    /// Source chart modification time (ns)
+    int64_t file_time_;
+
+    /// Stored layers
+    std::vector<layer> layers_;
+};
+
+}; // ~namespace encdata
@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * \file
+ * \brief ENC Chart Watcher
+ *
+ * Watches an ENC_ROOT directory tree (via inotify) for added, changed, or
+ * removed files, reporting them in batches once changes settle.
+ */
+
+#include <set>
+#include <map>
+#include <thread>
+#include <functional>
+#include <filesystem>
+
+namespace encdata
+{
+
+/// Chart directory watcher
+class chart_watcher
+{
+public:
+
+    /**
+     * Change Callback
+     *
+     * Called from the watcher thread with the set of changed files, or an
+     * empty set if events were lost and a full rescan is required.
+     */
+    typedef std::function<void(const std::set<std::filesystem::path> &)> callback;
+
+    /**
+     * Constructor
+     *
+     * \param[in] root Directory tree to watch
+     * \param[in] on_change Change callback
+     * \param[in] settle_ms Quiet time before reporting changes (ms)
+     */
+    chart_watcher(const std::filesystem::path &root, callback on_change,
+                  int settle_ms = 2000);
+
+    /**
+     * Destructor
+     */
+    ~chart_watcher();
+
+    chart_watcher(const chart_watcher &) = delete;
+    chart_watcher &operator=(const chart_watcher &) = delete;
+
+private:
+
+    /**
+     * Watch Directory Tree
+     *
+     * \param[in] dir Directory to (recursively) watch
+     */
+    void add_watch(const std::filesystem::path &dir);
+
+    /**
+     * Watcher Thread
+     */
+    void run();
+
+    /// Watched directory root
+    std::filesystem::path root_;
+
+    /// Change callback
+    callback on_change_;
+
+    /// Quiet time before reporting changes (ms)
+    int settle_ms_;
+
+    /// Inotify handle
+    int inotify_fd_;
+
+    /// Stop signal pipe
+    int stop_fd_[2];
+
+    /// Watched directories by watch descriptor
+    std::map<int, std::filesystem::path> dirs_;
+
+    /// Watcher thread
+    std::thread thread_;
+};
+
+}; // ~namespace encdata
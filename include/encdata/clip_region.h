@@ -0,0 +1,102 @@
+#pragma once
+
+/**
+ * \file
+ * \brief Clip Region
+ *
+ * Area that exported features are clipped to. Features disjoint from the
+ * area are rejected by bounding box, features fully within it are copied
+ * through, and only those crossing its boundary are intersected.
+ * Rectangular areas are clipped without GEOS.
+ */
+
+#include <memory>
+#include <optional>
+#include <ogr_geometry.h>
+#include <encdata/rect_clipper.h>
+
+namespace encdata
+{
+
+/// Prepared clipping area
+class clip_region
+{
+public:
+
+    /**
+     * Constructor
+     *
+     * \param[in] area Clipping area
+     */
+    clip_region(std::unique_ptr<OGRGeometry> area);
+
+    /**
+     * Constructor
+     *
+     * \param[in] rect Rectangular clipping area
+     */
+    clip_region(const OGREnvelope &rect);
+
+    /**
+     * Get Clipping Area Bounding Box
+     *
+     * \return Bounding box (deg)
+     */
+    const OGREnvelope &bbox() const;
+
+    /**
+     * Clip Geometry
+     *
+     * \param[in] geo Input geometry
+     * \return Clipped geometry, or nullptr if outside area
+     */
+    std::unique_ptr<OGRGeometry> clip(const OGRGeometry &geo) const;
+
+    /**
+     * Clip Geometry
+     *
+     * \param[in] geo Input geometry (returned as is if within area)
+     * \return Clipped geometry, or nullptr if outside area
+     */
+    std::unique_ptr<OGRGeometry> clip(std::unique_ptr<OGRGeometry> geo) const;
+
+private:
+
+    /// Geometry relation to area
+    enum relation
+    {
+        OUTSIDE,  ///< Disjoint from area
+        INSIDE,   ///< Fully within area
+        CROSSING, ///< Crosses area boundary (or unknown)
+    };
+
+    /**
+     * Relate Geometry to Area
+     *
+     * \param[in] geo Input geometry
+     * \return Geometry relation
+     */
+    relation relate(const OGRGeometry &geo) const;
+
+    /**
+     * Intersect Geometry with Area
+     *
+     * \param[in] geo Input geometry
+     * \return Intersection, or nullptr if empty
+     */
+    std::unique_ptr<OGRGeometry> intersect(const OGRGeometry &geo) const;
+
+    /// Clipping area
+    std::unique_ptr<OGRGeometry> area_;
+
+    /// Clipping area bounding box
+    OGREnvelope bbox_;
+
+    /// Prepared clipping area (if supported)
+    OGRPreparedGeometryUniquePtr prepared_;
+
+    /// Rectangle clipper (for rectangular areas)
+    std::optional<rect_clipper> rect_;
+};
+
+}; // ~namespace encdata
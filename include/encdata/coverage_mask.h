@@ -0,0 +1,107 @@
+#pragma once
+
+/**
+ * \file
+ * \brief Coverage Mask
+ *
+ * Tracks which parts of an export area are covered by charts, as a bitmask
+ * of small cells rasterized from chart coverage polygons. Much cheaper than
+ * differencing polygons when only "is anything still missing?" matters.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <ogr_geometry.h>
+
+namespace encdata
+{
+
+/// Per export coverage bitmask
+class coverage_mask
+{
+public:
+
+    /**
+     * Constructor
+     *
+     * All cells start uncovered.
+     *
+     * \param[in] bbox Masked area (deg)
+     * \param[in] cols Cells across
+     * \param[in] rows Cells down
+     */
+    coverage_mask(const OGREnvelope &bbox, int cols, int rows);
+
+    /**
+     * Restrict to Area
+     *
+     * Marks cells outside area as covered, so only the area must be filled.
+     *
+     * \param[in] area Polygon, or collection of polygons
+     */
+    void restrict(const OGRGeometry &area);
+
+    /**
+     * Add Covered Area
+     *
+     * A cell is covered once its center is within a polygon.
+     *
+     * \param[in] area Polygon, or collection of polygons
+     * \return Number of cells newly covered
+     */
+    std::size_t add(const OGRGeometry &area);
+
+    /**
+     * Check If Fully Covered
+     *
+     * \return True if no cells are left uncovered
+     */
+    bool full() const;
+
+    /**
+     * Get Uncovered Cell Count
+     *
+     * \return Cells left uncovered
+     */
+    std::size_t remaining() const;
+
+private:
+
+    /**
+     * Add Covered Polygon
+     *
+     * \param[in] poly Polygon (rings filled even-odd)
+     * \return Number of cells newly covered
+     */
+    std::size_t add_polygon(const OGRPolygon &poly);
+
+    /**
+     * Cover Row Span
+     *
+     * \param[in] row Cell row
+     * \param[in] first First cell column
+     * \param[in] last One past last cell column
+     * \return Number of cells newly covered
+     */
+    std::size_t fill(int row, int first, int last);
+
+    /// Masked area (deg)
+    OGREnvelope bbox_;
+
+    /// Cells across
+    int cols_;
+
+    /// Cells down
+    int rows_;
+
+    /// Words per row
+    int stride_;
+
+    /// Cell bits by row (set if covered, padding always set)
+    std::vector<uint64_t> bits_;
+
+    /// Cells left uncovered
+    std::size_t remaining_;
+};
+
+}; // ~namespace encdata
@@ -9,31 +9,66 @@
  * data for later handling.
  */
 
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 #include <filesystem>
 #include <gdal_priv.h>
 #include <ogrsf_frmts.h>
+#include <encdata/chart_cache.h>
+#include <encdata/chart_index.h>
+#include <encdata/chart_metadata.h>
+#include <encdata/chart_store.h>
+#include <encdata/clip_region.h>
+#include <encdata/coverage_mask.h>
+#include <encdata/export_stats.h>
+#include <encdata/chart_watcher.h>
+#include <encdata/feature_set.h>
+#include <encdata/land_index.h>
+#include <encdata/metadata_file.h>
 
 namespace encdata
 {
 
-/// Wrapper class to handle ENC data requests
+/**
+ * Wrapper class to handle ENC data requests
+ *
+ * Exports are safe to run concurrently from multiple threads. Each request
+ * works from an immutable snapshot of the chart set, and uses its own
+ * exclusively leased chart datasets. Configuration (set_*) is not, and should
+ * be completed before charts are loaded.
+ */
 class enc_dataset
 {
 public:
 
     /// Per chart metadata
-    struct metadata
+    typedef chart_metadata metadata;
+
+    /// Exported layer specification
+    struct layer_spec
     {
-        /// Path to data file
-        std::filesystem::path path;
+        /// Layer name (S57 object class)
+        std::string name;
 
-        /// Compilation of scale (DSPM CSCL)
-        int scale;
+        /// Attributes to export (all if not set)
+        std::optional<std::vector<std::string>> fields;
 
-        /// Bounding box (deg)
-        OGREnvelope bbox;
+        /// Clip margin around rectangular export bounds, as a fraction of
+        /// their size (ignored for polygon bounds)
+        double margin = 0;
+
+        /**
+         * Check Attribute Is Wanted
+         *
+         * \param[in] field Attribute name
+         * \return True if attribute should be exported
+         */
+        bool wants(const char *field) const;
     };
 
     /**
@@ -41,6 +76,11 @@ public:
      */
     enc_dataset();
 
+    /**
+     * Destructor
+     */
+    ~enc_dataset();
+
     /**
      * Set Cache Path
      *
@@ -48,6 +88,59 @@ public:
      */
     void set_cache_path(const std::filesystem::path &cache_path);
 
+    /**
+     * Set Chart Indexing Threads
+     *
+     * \param[in] threads Worker thread count (0 = hardware concurrency)
+     */
+    void set_index_threads(unsigned int threads);
+
+    /**
+     * Set Chart Dataset Cache Budget
+     *
+     * \param[in] bytes Size budget for idle opened charts (bytes)
+     */
+    void set_chart_cache(std::size_t bytes);
+
+    /**
+     * Get Chart Dataset Cache Counters
+     *
+     * \return Current counters
+     */
+    chart_cache::stats get_cache_stats() const;
+
+    /**
+     * Set Export Clipping Threads
+     *
+     * Charts used by a single export are clipped in parallel by this many
+     * threads, with features merged back in chart order.
+     *
+     * \param[in] threads Worker thread count (1 = sequential, 0 = hardware concurrency)
+     */
+    void set_clip_threads(unsigned int threads);
+
+    /**
+     * Set Coverage Mask Resolution
+     *
+     * When set, exports track remaining uncovered area with a bitmask of this
+     * many cells across (and down), rather than checking the polygon residue
+     * after every chart.
+     *
+     * \param[in] cells Mask cells across export area (0 = polygon residue only)
+     */
+    void set_coverage_mask(int cells);
+
+    /**
+     * Enable Preprocessed Chart Store
+     *
+     * When enabled, a compact chart store is built for each chart alongside
+     * its cached metadata, and used for feature set export instead of the S57
+     * chart. Dataset export always reads the S57 chart.
+     *
+     * \param[in] enable Build and use chart stores
+     */
+    void set_chart_store(bool enable);
+
     /**
      * Set Default Land Coverage
      *
@@ -65,6 +158,9 @@ public:
     /**
      * Recursively Load ENC Charts
      *
+     * Replaces any previously loaded charts. Only new charts, or charts
+     * whose files changed since last indexed, are parsed.
+     *
      * \param[in] enc_root ENC_ROOT base directory
      */
     void load_charts(const std::string &enc_root);
@@ -77,6 +173,17 @@ public:
      */
     bool load_chart(const std::filesystem::path &path);
 
+    /**
+     * Watch for ENC Chart Changes
+     *
+     * Watches ENC_ROOT for new, updated, or removed charts, and re-indexes
+     * just those charts as they change. Updated chart sets are published
+     * atomically, so in-flight requests continue with the previous set.
+     *
+     * \param[in] enc_root ENC_ROOT base directory
+     */
+    void watch_charts(const std::string &enc_root);
+
     /**
      * Export ENC Data to Empty Dataset
      *
@@ -87,10 +194,12 @@ public:
      * \param[in] layers Specified ENC layers (S57)
      * \param[in] bbox Data bounding box (deg)
      * \param[in] scale_min Minimum data compilation scale
+     * \param[out] stats Export statistics (nullptr to skip)
      * \return False if no data available
      */
     bool export_data(GDALDataset *ods, const std::vector<std::string> &layers,
-                     const OGREnvelope &bbox, int scale_min);
+                     const OGREnvelope &bbox, int scale_min,
+                     export_stats *stats = nullptr);
 
     /**
      * Export ENC Data to Empty Dataset
@@ -102,36 +211,155 @@ public:
      * \param[in] layers Specified ENC layers (S57)
      * \param[in] poly Data bounds (deg)
      * \param[in] scale_min Minimum data compilation scale
+     * \param[out] stats Export statistics (nullptr to skip)
      * \return False if no data available
      */
     bool export_data(GDALDataset *ods, const std::vector<std::string> &layers,
-                     const OGRPolygon &poly, int scale_min);
+                     const OGRPolygon &poly, int scale_min,
+                     export_stats *stats = nullptr);
+
+    /**
+     * Export ENC Data to Feature Set
+     *
+     * Replaces feature set contents with specified layers, populating with best
+     * data available for given bounding box and minimum presentation scale.
+     * Only numeric attributes are kept, and only those requested per layer.
+     * Each layer is clipped to the bounding box grown by its margin.
+     *
+     * \param[out] out Output feature set
+     * \param[in] layers Specified ENC layers (S57), and their attributes
+     * \param[in] bbox Data bounding box (deg)
+     * \param[in] scale_min Minimum data compilation scale
+     * \param[out] stats Export statistics (nullptr to skip)
+     * \return False if no data available
+     */
+    bool export_data(feature_set &out, const std::vector<layer_spec> &layers,
+                     const OGREnvelope &bbox, int scale_min,
+                     export_stats *stats = nullptr);
 
 private:
 
+    /// Destination for exported features
+    class export_sink;
+
+    /// Exports features to GDAL dataset layers
+    class dataset_sink;
+
+    /// Exports features to a feature set
+    class feature_sink;
+
+    /// Buffers exported features, to be replayed into another sink later
+    class buffer_sink;
+
+    /// Immutable set of loaded charts, shared with in-flight requests
+    struct chart_set
+    {
+        /// Loaded chart metadata by chart name (stem)
+        std::map<std::string, metadata> charts;
+
+        /// Spatial index of loaded charts
+        chart_index index;
+
+        /// Indexed charts, in ascending scale order (matches index entries)
+        std::vector<const metadata*> ordered;
+
+        /// Simplified coverage polygon of each indexed chart (may be null)
+        std::vector<std::unique_ptr<OGRGeometry>> areas;
+
+        /// Mapped chart store of each indexed chart (may be null)
+        std::vector<std::shared_ptr<const chart_store>> stores;
+    };
+
     /**
-     * Save Single ENC Chart To Cache
+     * Export ENC Data for Region
      *
-     * \param[in] path Path to ENC chart
+     * \param[out] sink Output features
+     * \param[in] layers Specified ENC layers (S57), and their attributes
+     * \param[in] poly Data bounds (deg)
+     * \param[in] rect Data bounds, if poly is a rectangle (grown by layer margins, deg)
+     * \param[in] scale_min Minimum data compilation scale
+     * \param[out] stats Export statistics (nullptr to skip)
+     * \return False if no data available
+     */
+    bool export_region(export_sink &sink, const std::vector<layer_spec> &layers,
+                       const OGRPolygon &poly, const OGREnvelope *rect, int scale_min,
+                       export_stats *stats);
+
+    /**
+     * Get Current Chart Set
+     *
+     * \return Chart set snapshot
+     */
+    std::shared_ptr<const chart_set> get_charts() const;
+
+    /**
+     * Index and Publish Chart Set
+     *
+     * Charts whose recorded chart store cannot be mapped are marked as
+     * having none, so they are parsed again when next indexed.
+     *
+     * \param[in] charts Chart metadata by chart name (stem)
+     * \return Published chart set
+     */
+    std::shared_ptr<const chart_set> publish(std::map<std::string, metadata> charts);
+
+    /**
+     * Update Changed ENC Charts
+     *
+     * \param[in] files Changed chart files
+     */
+    void update_charts(const std::set<std::filesystem::path> &files);
+
+    /**
+     * Index Single ENC Chart
+     *
+     * Cached metadata is used only if its fingerprint (file size and time)
+     * still matches, and a current chart store was built if stores are in
+     * use, otherwise the chart is parsed again. Safe to call concurrently,
+     * as no dataset state is modified.
+     *
+     * \param[in,out] meta Chart metadata (with path and fingerprint set)
+     * \param[out] parsed Chart was parsed from disk (not cached)
      * \return False on failure
      */
-    bool save_chart_cache(const metadata &meta);
+    bool index_chart(metadata &meta, bool &parsed) const;
 
     /**
-     * Load Single ENC Chart From Cache
+     * Save Chart Metadata File
      *
-     * \param[in] path Path to ENC chart
+     * Rewrites metadata file with given charts, and maps it.
+     *
+     * \param[in] charts Chart set to save
      * \return False on failure
      */
-    bool load_chart_cache(const std::filesystem::path &path);
+    bool save_metadata(const chart_set &charts);
 
     /**
      * Load Single ENC Chart From Disk
      *
-     * \param[in] path Path to ENC chart
+     * \param[in,out] meta Chart metadata (with path and fingerprint set)
      * \return False on failure
      */
-    bool load_chart_disk(const std::filesystem::path &path);
+    bool load_chart_disk(metadata &meta) const;
+
+    /**
+     * Get Chart Store Path
+     *
+     * \param[in] meta Chart metadata
+     * \return Path to chart store file
+     */
+    std::filesystem::path get_store_path(const metadata &meta) const;
+
+    /**
+     * Get Chart Store
+     *
+     * \param[in] meta Chart metadata
+     * \param[in] mapped Already mapped chart stores by chart path
+     * \return Mapped chart store, or nullptr if none is current
+     */
+    std::shared_ptr<const chart_store> get_store(
+        const metadata &meta,
+        const std::map<std::string, std::shared_ptr<const chart_store>> &mapped) const;
 
     /**
      * Get OGR Integer Field
@@ -140,61 +368,108 @@ private:
      * \param[in] name Field name
      * \return Requested value
      */
-    int get_feat_field_int(OGRFeature *feat, const char *name);
+    static int get_feat_field_int(OGRFeature *feat, const char *name);
 
     /**
-     * Create Temporary Dataset
+     * Layers With All Attributes
      *
-     * \return Created dataset
+     * \param[in] layers Layer names (S57)
+     * \return Layer specifications, keeping all attributes
      */
-    std::unique_ptr<GDALDataset> create_temp_dataset();
+    static std::vector<layer_spec> all_fields(const std::vector<std::string> &layers);
 
     /**
-     * Create Layer
+     * Rectangle to Polygon
      *
-     * \param[out] ds Dataset for layer
-     * \param[in] name Name of layer
-     * \return Created dataset
+     * \param[in] bbox Bounding box
+     * \return Polygon of bounding box
      */
-    OGRLayer *create_layer(GDALDataset *ds, const char *name);
+    static OGRPolygon rect_to_polygon(const OGREnvelope &bbox);
 
     /**
-     * Copy ENC Chart Coverage
+     * Get ENC Chart Coverage
      *
-     * \param[out] layer Output layer
+     * \param[out] area Coverage polygons
      * \param[in] ds Input dataset
      */
-    void copy_chart_coverage(OGRLayer *layer, GDALDataset *ds);
+    static void get_chart_coverage(OGRMultiPolygon &area, GDALDataset *ds);
 
     /**
-     * Clear Layer Features
+     * Get Chart Store Coverage
      *
-     * \param[out] layer OGR layer
+     * \param[out] area Coverage polygons
+     * \param[in] store Chart store
      */
-    void clear_layer(OGRLayer *layer);
+    static void get_store_coverage(OGRMultiPolygon &area, const chart_store &store);
 
     /**
-     * Polygon to Layer Feature
+     * Clip Layer Features
+     *
+     * Features disjoint from the clip region are skipped by bounding box
+     * (using the layer spatial filter), and those fully within it are copied
+     * without clipping. Unwanted fields are ignored while reading.
+     *
+     * \param[out] sink Output features
+     * \param[in] olayer Output layer index
+     * \param[in] spec Output layer specification
+     * \param[in] ilayer Input layer
+     * \param[in] region Clip region
+     * \param[out] lstats Layer statistics (nullptr to skip)
+     */
+    static void clip_features(export_sink &sink, std::size_t olayer, const layer_spec &spec,
+                              OGRLayer *ilayer, const clip_region &region,
+                              export_stats::layer_stats *lstats);
+
+    /**
+     * Clip Chart Store Features
+     *
+     * Features disjoint from the clip region are skipped by bounding box
+     * before their geometry is built.
      *
-     * \param[out] layer GDAL output layer
-     * \param[in] bbox OGR Polygon
+     * \param[out] sink Output features
+     * \param[in] olayer Output layer index
+     * \param[in] spec Output layer specification
+     * \param[in] slayer Chart store layer
+     * \param[in] region Clip region
+     * \param[out] lstats Layer statistics (nullptr to skip)
      */
-    void create_poly_feature(OGRLayer *layer, const OGRPolygon &poly);
+    static void clip_features(export_sink &sink, std::size_t olayer, const layer_spec &spec,
+                              const chart_store::layer &slayer,
+                              const clip_region &region,
+                              export_stats::layer_stats *lstats);
 
-    /// Loaded chart metadata by chart name (stem)
-    std::map<std::string, metadata> charts_;
+    /// Current chart set (atomically swapped on update)
+    std::shared_ptr<const chart_set> charts_;
+
+    /// Serializes chart set updates
+    std::mutex update_mutex_;
 
     /// Chart data cache location
     std::filesystem::path cache_;
 
-    /// GDAL memory driver handle
-    GDALDriver *mem_drv_;
+    /// Mapped chart metadata file
+    metadata_file meta_file_;
+
+    /// Chart indexing worker threads (0 = hardware concurrency)
+    unsigned int index_threads_;
+
+    /// Export clipping worker threads (1 = sequential, 0 = hardware concurrency)
+    unsigned int clip_threads_;
+
+    /// Coverage mask cells across export area (0 = polygon residue only)
+    int coverage_cells_;
+
+    /// Opened chart datasets, kept across requests
+    chart_cache datasets_;
+
+    /// Build and use preprocessed chart stores
+    bool use_store_;
 
-    /// Default land coverage file name
-    std::string land_file_name_;
+    /// Default land coverage, kept in memory
+    land_index land_;
 
-    /// Default land coverage layer name
-    std::string land_layer_name_;
+    /// Chart directory watcher (stopped first on destruction)
+    std::unique_ptr<chart_watcher> watcher_;
 };
 
 }; // ~namespace encviz
@@ -0,0 +1,96 @@
+#pragma once
+
+/**
+ * \file
+ * \brief ENC Export Statistics
+ *
+ * Counters and per stage timing filled in by enc_dataset exports, when
+ * requested. Stats from many exports may be summed for reporting.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace encdata
+{
+
+/// Export statistics
+struct export_stats
+{
+    /// Timed export stages
+    enum stage
+    {
+        SELECT,      ///< Chart selection
+        OPEN,        ///< Opening chart datasets (or stores)
+        CLIP,        ///< Reading and clipping features
+        COVERAGE,    ///< Removing chart coverage from missing area
+        LAND,        ///< Default land fallback
+        STAGE_COUNT, ///< Number of stages
+    };
+
+    /// Per layer counters
+    struct layer_stats
+    {
+        /// Layer name
+        std::string name;
+
+        /// Features read from charts (after bounding box filtering)
+        uint64_t features_in = 0;
+
+        /// Features exported
+        uint64_t features_out = 0;
+    };
+
+    /// Number of exports
+    uint64_t exports = 0;
+
+    /// Charts found by spatial index
+    uint64_t charts_considered = 0;
+
+    /// Charts whose coverage intersects export area
+    uint64_t charts_selected = 0;
+
+    /// Charts opened and processed
+    uint64_t charts_opened = 0;
+
+    /// Selected charts skipped, as area was already covered
+    uint64_t charts_skipped = 0;
+
+    /// Time spent per stage (ns)
+    uint64_t stage_ns[STAGE_COUNT] = {};
+
+    /// Per layer counters
+    std::vector<layer_stats> layers;
+
+    /**
+     * Clear Statistics
+     */
+    void clear();
+
+    /**
+     * Add Statistics
+     *
+     * Layers are matched by name.
+     *
+     * \param[in] other Statistics to add
+     */
+    void add(const export_stats &other);
+
+    /**
+     * Get Stage Name
+     *
+     * \param[in] s Export stage
+     * \return Stage name
+     */
+    static const char *stage_name(stage s);
+
+    /**
+     * Format as Text
+     *
+     * \return Human readable summary
+     */
+    std::string to_string() const;
+};
+
+}; // ~namespace encdata
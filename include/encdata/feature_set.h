@@ -0,0 +1,204 @@
+#pragma once
+
+/**
+ * \file
+ * \brief ENC Feature Set
+ *
+ * Lean container of exported features, with geometry held in flat
+ * coordinate arrays and numeric attributes in columns. Storage is kept
+ * when cleared, so a reused set stops allocating once warmed up.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ogr_geometry.h>
+#include <encdata/geometry_parts.h>
+
+namespace encdata
+{
+
+/// Set of exported feature layers
+class feature_set
+{
+public:
+
+    /// Geometry part
+    struct part
+    {
+        /// First coordinate
+        uint32_t first;
+
+        /// Number of coordinates
+        uint32_t count;
+
+        /// Part kind
+        part_kind kind;
+    };
+
+    /// Feature
+    struct feature
+    {
+        /// First geometry part
+        uint32_t part_first;
+
+        /// Number of geometry parts
+        uint32_t part_count;
+
+        /// Geometry has elevation (i.e. soundings)
+        bool is_3d;
+
+        /// Polygon outlines are drawn (false for pieces of a split polygon)
+        bool outline;
+    };
+
+    /// Layer of features
+    class layer
+    {
+    public:
+
+        /**
+         * Clear Features
+         *
+         * Storage is kept for reuse.
+         *
+         * \param[in] name New layer name
+         */
+        void clear(const std::string &name);
+
+        /**
+         * Get Layer Name
+         *
+         * \return Layer name
+         */
+        const std::string &name() const;
+
+        /**
+         * Add Numeric Attribute
+         *
+         * Existing features have no value (NaN) for new attributes.
+         *
+         * \param[in] name Attribute name
+         * \return Attribute index
+         */
+        std::size_t add_attr(const std::string &name);
+
+        /**
+         * Find Numeric Attribute
+         *
+         * \param[in] name Attribute name
+         * \return Attribute index, or -1 if not present
+         */
+        int find_attr(const char *name) const;
+
+        /**
+         * Add Feature
+         *
+         * Collections are flattened into their component parts, and
+         * anything other than points, lines, and polygons is dropped.
+         *
+         * \param[in] geo Feature geometry
+         * \param[in] outline Draw polygon outlines
+         * \return Feature index (attributes initially NaN)
+         */
+        std::size_t add_feature(const OGRGeometry &geo, bool outline = true);
+
+        /**
+         * Set Attribute Value
+         *
+         * \param[in] idx Feature index
+         * \param[in] attr Attribute index
+         * \param[in] value Attribute value
+         */
+        void set_attr(std::size_t idx, std::size_t attr, double value);
+
+        /**
+         * Get Attribute Value
+         *
+         * \param[in] idx Feature index
+         * \param[in] attr Attribute index (may be -1)
+         * \return Attribute value (NaN if unset)
+         */
+        double attr(std::size_t idx, int attr) const;
+
+        /**
+         * Get Feature Count
+         *
+         * \return Number of features
+         */
+        std::size_t size() const;
+
+        /// Features
+        std::vector<feature> features;
+
+        /// Geometry parts
+        std::vector<part> parts;
+
+        /// Coordinates (Z is zero for 2D geometry)
+        std::vector<double> x, y, z;
+
+    private:
+
+        /// Layer name
+        std::string name_;
+
+        /// Numeric attribute names
+        std::vector<std::string> attr_names_;
+
+        /// Attribute values, by attribute then feature
+        std::vector<std::vector<double>> attr_values_;
+    };
+
+    /**
+     * Constructor
+     */
+    feature_set();
+
+    /**
+     * Clear All Layers
+     *
+     * Storage is kept for reuse.
+     */
+    void clear();
+
+    /**
+     * Add Layer
+     *
+     * \param[in] name Layer name
+     * \return Empty layer
+     */
+    layer &add_layer(const std::string &name);
+
+    /**
+     * Find Layer
+     *
+     * \param[in] name Layer name
+     * \return Layer, or nullptr if not present
+     */
+    const layer *find_layer(const std::string &name) const;
+
+    /**
+     * Get Layer Count
+     *
+     * \return Number of layers
+     */
+    std::size_t size() const;
+
+    /**
+     * Get Layer
+     *
+     * \param[in] idx Layer index
+     * \return Layer
+     */
+    layer &operator[](std::size_t idx);
+
+private:
+
+    /// Layers (including unused, kept for storage)
+    std::vector<layer> layers_;
+
+    /// Number of layers in use
+    std::size_t count_;
+};
+
+}; // ~namespace encdata
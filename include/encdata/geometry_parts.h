@@ -0,0 +1,118 @@
+#pragma once
+
+/**
+ * \file
+ * \brief Geometry Parts
+ *
+ * Flattening of OGR geometry into simple parts (points, lines, and polygon
+ * rings) over contiguous coordinate arrays, as shared by exported feature
+ * sets and chart stores.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <ogr_geometry.h>
+
+namespace encdata
+{
+
+/// Geometry part kinds
+enum part_kind : uint32_t
+{
+    POINT,      ///< Single point
+    LINE,       ///< Line string
+    OUTER_RING, ///< Polygon exterior ring (starts a new polygon)
+    INNER_RING, ///< Polygon interior ring
+};
+
+/**
+ * Add Geometry Part
+ *
+ * Parts are built as { first coordinate, coordinate count, kind }.
+ *
+ * \param[out] parts Geometry parts
+ * \param[out] x,y,z Coordinates (Z is zero for 2D geometry)
+ * \param[in] curve Points of part
+ * \param[in] kind Part kind
+ */
+template <typename Part>
+void add_geometry_part(std::vector<Part> &parts, std::vector<double> &x,
+                       std::vector<double> &y, std::vector<double> &z,
+                       const OGRSimpleCurve &curve, part_kind kind)
+{
+    parts.push_back({ (uint32_t)x.size(), (uint32_t)curve.getNumPoints(), kind });
+    for (int i = 0; i < curve.getNumPoints(); i++)
+    {
+        x.push_back(curve.getX(i));
+        y.push_back(curve.getY(i));
+        z.push_back(curve.getZ(i));
+    }
+}
+
+/**
+ * Add Geometry Parts
+ *
+ * Collections are flattened into their component parts. Anything else
+ * (ie - curves, which S57 does not have) is dropped, as are empty points.
+ *
+ * \param[out] parts Geometry parts
+ * \param[out] x,y,z Coordinates (Z is zero for 2D geometry)
+ * \param[in] geo Geometry
+ */
+template <typename Part>
+void add_geometry_parts(std::vector<Part> &parts, std::vector<double> &x,
+                        std::vector<double> &y, std::vector<double> &z,
+                        const OGRGeometry &geo)
+{
+    switch (wkbFlatten(geo.getGeometryType()))
+    {
+        case wkbPoint:
+        {
+            const OGRPoint *point = geo.toPoint();
+            if (!point->IsEmpty())
+            {
+                parts.push_back({ (uint32_t)x.size(), 1, POINT });
+                x.push_back(point->getX());
+                y.push_back(point->getY());
+                z.push_back(point->getZ());
+            }
+            break;
+        }
+
+        case wkbLineString:
+            add_geometry_part(parts, x, y, z, *geo.toLineString(), LINE);
+            break;
+
+        case wkbPolygon:
+        {
+            const OGRPolygon *poly = geo.toPolygon();
+            if (poly->getExteriorRing() != nullptr)
+            {
+                add_geometry_part(parts, x, y, z, *poly->getExteriorRing(), OUTER_RING);
+                for (int i = 0; i < poly->getNumInteriorRings(); i++)
+                {
+                    add_geometry_part(parts, x, y, z, *poly->getInteriorRing(i), INNER_RING);
+                }
+            }
+            break;
+        }
+
+        case wkbMultiPoint:
+        case wkbMultiLineString:
+        case wkbMultiPolygon:
+        case wkbGeometryCollection:
+        {
+            const OGRGeometryCollection *coll = geo.toGeometryCollection();
+            for (int i = 0; i < coll->getNumGeometries(); i++)
+            {
+                add_geometry_parts(parts, x, y, z, *coll->getGeometryRef(i));
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+}; // ~namespace encdata
@@ -0,0 +1,121 @@
+#pragma once
+
+/**
+ * \file
+ * \brief Default Land Index
+ *
+ * Background land coverage (ie - GSHHS), loaded once and kept in memory.
+ * Polygons are split along a quadtree until each piece is small, so a tile
+ * only ever touches the few pieces that intersect it.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ogr_geometry.h>
+
+namespace encdata
+{
+
+/// Quadtree of land polygon pieces
+class land_index
+{
+public:
+
+    /// Most vertices kept in one piece, unless at maximum depth
+    static constexpr std::size_t max_points = 256;
+
+    /// Maximum quadtree depth
+    static constexpr int max_depth = 16;
+
+    /**
+     * Constructor
+     */
+    land_index();
+
+    /**
+     * Load Land Layer
+     *
+     * Replaces any previously loaded land.
+     *
+     * \param[in] file_name Path to land coverage file
+     * \param[in] layer_name Land coverage layer (first layer if empty)
+     * \return False if layer cannot be read
+     */
+    bool load(const std::string &file_name, const std::string &layer_name);
+
+    /**
+     * Check If Empty
+     *
+     * \return True if no land is loaded
+     */
+    bool empty() const;
+
+    /**
+     * Query Land Polygons
+     *
+     * Pieces are returned as split, not merged back together, so their
+     * outlines include quadtree cell edges. Draw them fill only.
+     *
+     * \param[out] out Land polygons intersecting bounding box (replaced)
+     * \param[in] bbox Query bounding box (deg)
+     * \return Number of pieces checked against bounding box
+     */
+    std::size_t query(std::vector<std::unique_ptr<OGRGeometry>> &out,
+                      const OGREnvelope &bbox) const;
+
+private:
+
+    /// Polygon piece
+    struct piece
+    {
+        /// Bounding box
+        OGREnvelope bbox;
+
+        /// Piece geometry
+        std::unique_ptr<OGRGeometry> geo;
+    };
+
+    /// Quadtree node
+    struct node
+    {
+        /// Cell bounds
+        OGREnvelope bbox;
+
+        /// Child nodes (0 if none)
+        uint32_t children[4];
+
+        /// Pieces kept at this node
+        std::vector<uint32_t> pieces;
+    };
+
+    /**
+     * Get Child Node
+     *
+     * \param[in] parent Parent node index
+     * \param[in] quadrant Child quadrant (0 to 3)
+     * \return Child node index, created if missing
+     */
+    uint32_t get_child(uint32_t parent, int quadrant);
+
+    /**
+     * Insert Polygon Piece
+     *
+     * Large pieces are split into quadrants, small ones are kept in the
+     * smallest cell holding all of them.
+     *
+     * \param[in] idx Node index
+     * \param[in] depth Node depth
+     * \param[in] geo Piece geometry (within node bounds)
+     */
+    void insert(uint32_t idx, int depth, std::unique_ptr<OGRGeometry> geo);
+
+    /// Quadtree nodes (root first, if any)
+    std::vector<node> nodes_;
+
+    /// Polygon pieces
+    std::vector<piece> pieces_;
+};
+
+}; // ~namespace encdata
@@ -0,0 +1,204 @@
+#pragma once
+
+/**
+ * \file
+ * \brief Asynchronous Logger
+ *
+ * Leveled, process wide logger. Request threads only format into a fixed
+ * size lock-free ring buffer, and a background thread writes lines out, so
+ * logging never waits on stdout. Lines are dropped (and counted) if the
+ * ring is full.
+ */
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+/// Log message, if level is enabled (arguments are not evaluated otherwise)
+#define ENC_LOG(level, ...)                                           \
+    do {                                                              \
+        if (encdata::logger::get().enabled((level)))                  \
+            encdata::logger::get().write((level), __VA_ARGS__);       \
+    } while (0)
+
+/// Log debug message
+#define LOG_DEBUG(...) ENC_LOG(encdata::log_level::DEBUG, __VA_ARGS__)
+
+/// Log info message
+#define LOG_INFO(...) ENC_LOG(encdata::log_level::INFO, __VA_ARGS__)
+
+/// Log warning message
+#define LOG_WARN(...) ENC_LOG(encdata::log_level::WARN, __VA_ARGS__)
+
+/// Log error message
+#define LOG_ERROR(...) ENC_LOG(encdata::log_level::ERROR, __VA_ARGS__)
+
+namespace encdata
+{
+
+/// Log levels, in increasing severity
+enum class log_level : int
+{
+    DEBUG, ///< Per request detail
+    INFO,  ///< Normal operation (ie - access log)
+    WARN,  ///< Recoverable problems
+    ERROR, ///< Failures
+};
+
+/// Asynchronous leveled logger
+class logger
+{
+public:
+
+    /// Number of ring buffer slots
+    static constexpr std::size_t slot_count = 4096;
+
+    /// Longest logged message (longer ones are truncated)
+    static constexpr std::size_t message_size = 496;
+
+    /**
+     * Get Process Logger
+     *
+     * \return Logger instance (writer started on first use)
+     */
+    static logger &get();
+
+    /**
+     * Destructor
+     *
+     * Writes out any queued lines, then stops writer thread.
+     */
+    ~logger();
+
+    /**
+     * Set Minimum Level
+     *
+     * \param[in] level Least severe level written
+     */
+    void set_level(log_level level);
+
+    /**
+     * Parse Level Name
+     *
+     * \param[in] name Level name (debug, info, warn or error)
+     * \param[out] level Parsed level
+     * \return False if name is not recognized
+     */
+    static bool parse_level(const char *name, log_level &level);
+
+    /**
+     * Set Output Stream
+     *
+     * Lines already queued may still go to the previous stream, unless
+     * flush() is called first.
+     *
+     * \param[in] out Output stream (default stdout, not closed)
+     */
+    void set_output(FILE *out);
+
+    /**
+     * Check Level Is Enabled
+     *
+     * \param[in] level Message level
+     * \return True if messages of this level are written
+     */
+    bool enabled(log_level level) const;
+
+    /**
+     * Queue Message
+     *
+     * \param[in] level Message level
+     * \param[in] fmt Format string (printf style)
+     */
+    void write(log_level level, const char *fmt, ...)
+        __attribute__((format(printf, 3, 4)));
+
+    /**
+     * Wait for Queued Lines
+     *
+     * Returns once every line queued before the call has been written.
+     */
+    void flush();
+
+    /**
+     * Get Dropped Line Count
+     *
+     * \return Lines dropped as ring buffer was full
+     */
+    uint64_t dropped() const;
+
+private:
+
+    /// Ring buffer slot
+    struct slot
+    {
+        /// Sequence number (slot is ready to write when equal to position,
+        /// ready to read when one past it)
+        std::atomic<uint64_t> sequence;
+
+        /// Message level
+        log_level level;
+
+        /// Queue time (ns since epoch)
+        int64_t time;
+
+        /// Message text (null terminated)
+        char text[message_size];
+    };
+
+    /**
+     * Constructor
+     */
+    logger();
+
+    /**
+     * Writer Thread
+     */
+    void run();
+
+    /**
+     * Write Out Queued Lines
+     *
+     * \return False if nothing was queued
+     */
+    bool drain();
+
+    /// Minimum written level
+    std::atomic<int> level_;
+
+    /// Ring buffer
+    std::array<slot, slot_count> slots_;
+
+    /// Next position to queue (claimed by producers)
+    std::atomic<uint64_t> head_;
+
+    /// Next position to write (writer thread only)
+    std::atomic<uint64_t> tail_;
+
+    /// Lines dropped as ring buffer was full
+    std::atomic<uint64_t> dropped_;
+
+    /// Dropped lines already noted in output (writer thread only)
+    uint64_t reported_;
+
+    /// Output stream
+    std::atomic<FILE*> out_;
+
+    /// Writer thread should stop
+    std::atomic<bool> stop_;
+
+    /// Protects writer wakeups
+    std::mutex mutex_;
+
+    /// Wakes writer (on flush or stop, producers never wait)
+    std::condition_variable wake_;
+
+    /// Writer thread
+    std::thread writer_;
+};
+
+}; // ~namespace encdata
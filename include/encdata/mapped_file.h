@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * \file
+ * \brief Memory Mapped File
+ *
+ * Minimal RAII wrapper of a read-only memory mapped file.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace encdata
+{
+
+/// Read-only memory mapped file
+class mapped_file
+{
+public:
+
+    /**
+     * Constructor
+     */
+    mapped_file();
+
+    /**
+     * Destructor
+     */
+    ~mapped_file();
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    /**
+     * Map File
+     *
+     * \param[in] path Path to file
+     * \return False on failure (including empty files)
+     */
+    bool open(const std::filesystem::path &path);
+
+    /**
+     * Unmap File
+     */
+    void close();
+
+    /**
+     * Get Mapped Data
+     *
+     * \return Start of mapping, or nullptr if not mapped
+     */
+    const uint8_t *data() const;
+
+    /**
+     * Get Mapped Size
+     *
+     * \return Size of mapping in bytes
+     */
+    std::size_t size() const;
+
+private:
+
+    /// Start of mapping
+    const uint8_t *data_;
+
+    /// Size of mapping
+    std::size_t size_;
+};
+
+}; // ~namespace encdata
@@ -0,0 +1,130 @@
+#pragma once
+
+/**
+ * \file
+ * \brief ENC Metadata File
+ *
+ * Versioned binary file holding metadata for every indexed chart, memory
+ * mapped at startup so a warm start needs only a single open.
+ */
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <filesystem>
+#include <encdata/chart_metadata.h>
+#include <encdata/mapped_file.h>
+
+namespace encdata
+{
+
+/// Memory mapped chart metadata file
+class metadata_file
+{
+public:
+
+    /// File format version
+    static constexpr uint32_t version = 4;
+
+    /**
+     * Constructor
+     */
+    metadata_file();
+
+    /**
+     * Open Metadata File
+     *
+     * \param[in] path Path to metadata file
+     * \return False if missing, invalid, or wrong version
+     */
+    bool open(const std::filesystem::path &path);
+
+    /**
+     * Close Metadata File
+     */
+    void close();
+
+    /**
+     * Get Chart Count
+     *
+     * \return Number of charts in file
+     */
+    std::size_t size() const;
+
+    /// Per chart record (on disk)
+    struct record;
+
+    /**
+     * Find Chart Record
+     *
+     * Record is viewed in place in the mapped file, nothing is copied.
+     *
+     * \param[in] path Path to ENC chart
+     * \return Chart record (valid until file is closed), or nullptr if not present
+     */
+    const record *find(const std::filesystem::path &path) const;
+
+    /**
+     * Check Record Fingerprint
+     *
+     * \param[in] rec Chart record
+     * \param[in] meta Chart metadata (with fingerprint set)
+     * \return True if record has the same file size and time
+     */
+    static bool matches(const record &rec, const chart_metadata &meta);
+
+    /**
+     * Get Recorded Chart Store Version
+     *
+     * \param[in] rec Chart record
+     * \return Version of chart store built from chart (0 if none)
+     */
+    static uint32_t store_version(const record &rec);
+
+    /**
+     * Copy Chart Metadata
+     *
+     * \param[in] rec Chart record
+     * \param[in,out] meta Chart metadata (path is kept)
+     */
+    void copy(const record &rec, chart_metadata &meta) const;
+
+    /**
+     * Write Metadata File
+     *
+     * File is written to a temporary location, then atomically renamed into
+     * place, so readers always see either the old or new contents.
+     *
+     * \param[in] path Path to metadata file
+     * \param[in] charts Charts to save
+     * \return False on failure
+     */
+    static bool write(const std::filesystem::path &path,
+                      const std::vector<const chart_metadata*> &charts);
+
+private:
+
+    /// File header (on disk)
+    struct header;
+
+    /// Coverage bounds (on disk)
+    struct bounds;
+
+    /// Mapped file
+    mapped_file file_;
+
+    /// Chart records
+    const record *records_;
+
+    /// Coverage bounds
+    const bounds *coverage_;
+
+    /// String data (paths and coverage polygons)
+    const unsigned char *strings_;
+
+    /// Record index by chart path (viewing mapped strings)
+    std::unordered_map<std::string_view, uint32_t> lookup_;
+};
+
+}; // ~namespace encdata
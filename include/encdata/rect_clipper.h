@@ -0,0 +1,74 @@
+#pragma once
+
+/**
+ * \file
+ * \brief Rectangle Clipper
+ *
+ * Clips geometries to an axis aligned rectangle, using Liang-Barsky for
+ * lines and Sutherland-Hodgman for polygon rings. Much cheaper than a
+ * general (GEOS) intersection for tile shaped areas.
+ */
+
+#include <memory>
+#include <vector>
+#include <ogr_geometry.h>
+
+namespace encdata
+{
+
+/// Axis aligned rectangle clipper
+class rect_clipper
+{
+public:
+
+    /**
+     * Constructor
+     *
+     * \param[in] rect Clipping rectangle
+     */
+    rect_clipper(const OGREnvelope &rect);
+
+    /**
+     * Clip Geometry
+     *
+     * Polygons clipped against a concave boundary may keep zero area
+     * connecting edges along the rectangle boundary. Curved geometry (not
+     * present in S57) is not supported.
+     *
+     * \param[in] geo Input geometry
+     * \return Clipped geometry, or nullptr if outside rectangle
+     */
+    std::unique_ptr<OGRGeometry> clip(const OGRGeometry &geo) const;
+
+private:
+
+    /**
+     * Clip Line
+     *
+     * \param[out] out Clipped pieces (appended)
+     * \param[in] line Input line
+     */
+    void clip_line(std::vector<std::unique_ptr<OGRLineString>> &out,
+                   const OGRSimpleCurve &line) const;
+
+    /**
+     * Clip Polygon Ring
+     *
+     * \param[in] ring Input ring
+     * \return Clipped ring, or nullptr if outside rectangle
+     */
+    std::unique_ptr<OGRLinearRing> clip_ring(const OGRSimpleCurve &ring) const;
+
+    /**
+     * Clip Polygon
+     *
+     * \param[in] poly Input polygon
+     * \return Clipped polygon, or nullptr if outside rectangle
+     */
+    std::unique_ptr<OGRPolygon> clip_polygon(const OGRPolygon &poly) const;
+
+    /// Clipping rectangle
+    OGREnvelope rect_;
+};
+
+}; // ~namespace encdata
@@ -0,0 +1,101 @@
+#pragma once
+
+/**
+ * \file
+ * \brief Color Palette
+ *
+ * Indexed color table (up to 256 entries) for 8 bit tile output. Charts are
+ * drawn without antialiasing from a closed set of theme colors, so rendered
+ * pixels almost always match an entry exactly.
+ */
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <encviz/style.h>
+
+namespace encviz
+{
+
+/// Indexed color table
+class color_palette
+{
+public:
+
+    /// Maximum number of entries
+    static constexpr std::size_t max_size = 256;
+
+    /**
+     * Constructor
+     *
+     * Palette starts with fully transparent as index zero.
+     */
+    color_palette();
+
+    /**
+     * Add Color
+     *
+     * \param[in] c Straight ARGB color
+     * \return False if palette is full (color not added)
+     */
+    bool add(const color &c);
+
+    /**
+     * Get Number of Entries
+     *
+     * \return Palette size
+     */
+    std::size_t size() const;
+
+    /**
+     * Get Palette Entries
+     *
+     * \return Straight ARGB colors, by index
+     */
+    const std::vector<color> &entries() const;
+
+    /**
+     * Map Pixels to Palette
+     *
+     * Pixels not exactly in the palette (ie - blended text edges) are mapped
+     * to the nearest entry.
+     *
+     * \param[out] indexes Palette indexes (replaced, one per pixel)
+     * \param[in] pixels Premultiplied ARGB32 pixels (cairo)
+     * \param[in] count Number of pixels
+     */
+    void quantize(std::vector<uint8_t> &indexes, const uint32_t *pixels,
+                  std::size_t count) const;
+
+private:
+
+    /**
+     * Find Nearest Entry
+     *
+     * \param[in] pixel Premultiplied ARGB32 pixel
+     * \return Palette index
+     */
+    uint8_t nearest(uint32_t pixel) const;
+
+    /// Straight ARGB colors, by index
+    std::vector<color> entries_;
+
+    /// Premultiplied ARGB32 pixels, by index
+    std::vector<uint32_t> pixels_;
+
+    /// Index of each premultiplied pixel
+    std::unordered_map<uint32_t, uint8_t> lookup_;
+};
+
+/**
+ * Build Palette for Style
+ *
+ * Includes every color of the theme, plus any literal colors in the style.
+ *
+ * \param[in] style Render style
+ * \param[in] theme Color theme of style
+ * \return Palette (colors past the limit are dropped)
+ */
+color_palette build_palette(const render_style &style, const color_theme &theme);
+
+}; // ~namespace encviz
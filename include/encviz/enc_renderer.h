@@ -12,12 +12,24 @@
 #include <filesystem>
 #include <cairo.h>
 #include <encdata/enc_dataset.h>
+#include <encviz/color_palette.h>
+#include <encviz/png_encoder.h>
 #include <encviz/style.h>
+#include <encviz/uniform_tiles.h>
 #include <encviz/web_mercator.h>
+#include <encviz/webp_encoder.h>
 
 namespace encviz
 {
 
+/// Encoded tile image formats
+enum class tile_format
+{
+    PNG,  ///< 32 bit color PNG
+    PNG8, ///< Palette indexed PNG (style colors)
+    WEBP, ///< Lossless WebP (if built with libwebp)
+};
+
 class enc_renderer
 {
 public:
@@ -32,16 +44,102 @@ public:
     /**
      * Render Chart Data
      *
-     * \param[out] data PNG bytestream
+     * Safe to call concurrently from multiple threads, as configuration is
+     * only read once loaded, and each call renders to its own surface.
+     *
+     * \param[out] data Encoded image bytestream (in configured tile format)
      * \param[in] tc Tile coordinate system (WMTS or XYZ)
      * \param[in] x Tile X coordinate (horizontal)
      * \param[in] y Tile Y coordinate (vertical)
      * \param[in] z Tile Z coordinate (zoom)
      * \param[in] style_name Name of style
+     * \param[out] stats Data export statistics (nullptr to skip)
      * \return False if no data to render
      */
     bool render(std::vector<uint8_t> &data, tile_coords tc,
-                int x, int y, int z, const char *style_name);
+                int x, int y, int z, const char *style_name,
+                encdata::export_stats *stats = nullptr);
+
+    /**
+     * Render Chart Data in Format
+     *
+     * As render(), but in the requested tile format.
+     *
+     * \param[out] data Encoded image bytestream
+     * \param[in] format Tile format (see supports_format())
+     * \param[in] tc Tile coordinate system (WMTS or XYZ)
+     * \param[in] x Tile X coordinate (horizontal)
+     * \param[in] y Tile Y coordinate (vertical)
+     * \param[in] z Tile Z coordinate (zoom)
+     * \param[in] style_name Name of style
+     * \param[out] stats Data export statistics (nullptr to skip)
+     * \return False if no data to render
+     */
+    bool render(std::vector<uint8_t> &data, tile_format format, tile_coords tc,
+                int x, int y, int z, const char *style_name,
+                encdata::export_stats *stats = nullptr);
+
+    /**
+     * Render Chart Data to Pixels
+     *
+     * As render(), but leaves the unencoded image (ie - for benchmarks).
+     *
+     * \param[out] pixels Premultiplied ARGB32 pixels, by row (tile size squared)
+     * \param[in] tc Tile coordinate system (WMTS or XYZ)
+     * \param[in] x Tile X coordinate (horizontal)
+     * \param[in] y Tile Y coordinate (vertical)
+     * \param[in] z Tile Z coordinate (zoom)
+     * \param[in] style_name Name of style
+     * \param[out] stats Data export statistics (nullptr to skip)
+     * \return False if no data to render
+     */
+    bool render_pixels(std::vector<uint32_t> &pixels, tile_coords tc,
+                       int x, int y, int z, const char *style_name,
+                       encdata::export_stats *stats = nullptr);
+
+    /**
+     * Get Tile Size
+     *
+     * \return Dimension of output image
+     */
+    int get_tile_size() const;
+
+    /**
+     * Get Configured Tile Format
+     *
+     * \return Format used by render() unless another is requested
+     */
+    tile_format get_tile_format() const;
+
+    /**
+     * Check Tile Format Support
+     *
+     * \param[in] format Tile format
+     * \return False if format cannot be encoded (ie - built without libwebp)
+     */
+    static bool supports_format(tile_format format);
+
+    /**
+     * Get PNG Encoder
+     *
+     * \return Configured PNG encoder
+     */
+    const png_encoder &get_png_encoder() const;
+
+    /**
+     * Get Style Palette
+     *
+     * \param[in] style_name Name of style
+     * \return Palette of style colors (nullptr if no such style)
+     */
+    const color_palette *get_palette(const char *style_name) const;
+
+    /**
+     * Get WebP Encoder
+     *
+     * \return Configured WebP encoder
+     */
+    const webp_encoder &get_webp_encoder() const;
 
 private:
 
@@ -49,67 +147,106 @@ private:
      * Render Feature Geometry
      *
      * \param[out] cr Image context
-     * \param[in] geo Feature geometry
-     * \param[in] wm Web Mercator point mapper
+     * \param[in] layer Feature layer
+     * \param[in] idx Feature index
+     * \param[in] px Layer point columns (pixels)
+     * \param[in] py Layer point rows (pixels)
      * \param[in] style Feature style
      */
-    void render_geo(cairo_t *cr, const OGRGeometry *geo,
-                    const web_mercator &wm, const simple_style &style);
+    void render_feature(cairo_t *cr, const encdata::feature_set::layer &layer,
+                        std::size_t idx, const double *px, const double *py,
+                        const simple_style &style);
 
     /**
      * Render Depth Value
      *
      * \param[out] cr Image context
-     * \param[in] geo Feature geometry
-     * \param[in] wm Web Mercator point mapper
+     * \param[in] c Point location (pixels)
+     * \param[in] depth Depth value
      * \param[in] style Feature style
      */
-    void render_depth(cairo_t *cr, const OGRPoint *geo,
-                      const web_mercator &wm, const simple_style &style);
+    void render_depth(cairo_t *cr, const coord &c, double depth,
+                      const simple_style &style);
 
     /**
      * Render Point Geometry
      *
      * \param[out] cr Image context
-     * \param[in] geo Feature geometry
-     * \param[in] wm Web Mercator point mapper
+     * \param[in] c Point location (pixels)
      * \param[in] style Feature style
      */
-    void render_point(cairo_t *cr, const OGRPoint *geo,
-                      const web_mercator &wm, const simple_style &style);
+    void render_point(cairo_t *cr, const coord &c, const simple_style &style);
 
     /**
      * Render LineString Geometry
      *
      * \param[out] cr Image context
-     * \param[in] geo Feature geometry
-     * \param[in] wm Web Mercator point mapper
+     * \param[in] layer Feature layer
+     * \param[in] part Line geometry part
+     * \param[in] px Layer point columns (pixels)
+     * \param[in] py Layer point rows (pixels)
      * \param[in] style Feature style
      */
-    void render_line(cairo_t *cr, const OGRLineString *geo,
-                     const web_mercator &wm, const simple_style &style);
+    void render_line(cairo_t *cr, const encdata::feature_set::layer &layer,
+                     const encdata::feature_set::part &part,
+                     const double *px, const double *py, const simple_style &style);
 
     /**
      * Render Polygon Geometry
      *
      * \param[out] cr Image context
-     * \param[in] geo Feature geometry
-     * \param[in] wm Web Mercator point mapper
+     * \param[in] layer Feature layer
+     * \param[in] ring_first Exterior ring part index
+     * \param[in] ring_end Index past last interior ring part
+     * \param[in] px Layer point columns (pixels)
+     * \param[in] py Layer point rows (pixels)
      * \param[in] style Feature style
+     * \param[in] outline Draw outline as well as fill
      */
-    void render_poly(cairo_t *cr, const OGRPolygon *geo,
-                     const web_mercator &wm, const simple_style &style);
+    void render_poly(cairo_t *cr, const encdata::feature_set::layer &layer,
+                     std::size_t ring_first, std::size_t ring_end,
+                     const double *px, const double *py, const simple_style &style,
+                     bool outline);
+
+    /**
+     * Trace Geometry Part
+     *
+     * \param[out] cr Image context
+     * \param[in] layer Feature layer
+     * \param[in] part Geometry part
+     * \param[in] px Layer point columns (pixels)
+     * \param[in] py Layer point rows (pixels)
+     */
+    void trace_part(cairo_t *cr, const encdata::feature_set::layer &layer,
+                    const encdata::feature_set::part &part,
+                    const double *px, const double *py);
 
     /**
      * Choose Feature Style
      *
-     * \param[in] feat Specified feature
+     * \param[in] layer Feature layer
+     * \param[in] idx Feature index
+     * \param[in] cutoff_attr Index of cutoff attribute (-1 if missing)
      * \param[in] lstyle Layer styles
      * \return Selected style
      */
-    const simple_style &get_feat_style(const OGRFeatureUniquePtr &feat,
+    const simple_style &get_feat_style(const encdata::feature_set::layer &layer,
+                                       std::size_t idx, int cutoff_attr,
                                        const layer_style &lstyle);
 
+    /**
+     * Get Exported Layers of Style
+     *
+     * Layers are listed once each, with only the attributes used for cutoffs,
+     * and the largest clip margin of any style for the layer.
+     *
+     * \param[in] style Render style
+     * \param[in] tile_size Dimension of output image
+     * \return Layer specifications
+     */
+    static std::vector<encdata::enc_dataset::layer_spec>
+    get_layer_specs(const render_style &style, int tile_size);
+
     /**
      * Set Render Color
      *
@@ -131,11 +268,29 @@ private:
     /// Min display scale at zoom=0
     double min_scale0_;
 
+    /// Encoded tile format
+    tile_format format_;
+
+    /// PNG tile encoder
+    png_encoder png_;
+
+    /// WebP tile encoder
+    webp_encoder webp_;
+
+    /// Encoded single color tiles, shared by all requests
+    uniform_tiles uniform_;
+
     /// Chart collection
     encdata::enc_dataset enc_;
 
     /// Loaded styles
     std::map<std::string, render_style> styles_;
+
+    /// Color palette of each loaded style
+    std::map<std::string, color_palette> palettes_;
+
+    /// Exported layers of each loaded style
+    std::map<std::string, std::vector<encdata::enc_dataset::layer_spec>> style_layers_;
 };
 
 }; // ~namespace encviz
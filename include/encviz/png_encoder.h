@@ -0,0 +1,135 @@
+#pragma once
+
+/**
+ * \file
+ * \brief PNG Encoder
+ *
+ * Encodes rendered tiles (cairo ARGB32 pixels) to PNG with libpng, with
+ * tunable compression level, row filter and deflate strategy. Fully opaque
+ * tiles are written without an alpha channel. Indexed (PNG8) output is also
+ * supported for palette rendered tiles.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <encviz/color_palette.h>
+
+namespace encviz
+{
+
+/// PNG encoder settings
+struct png_options
+{
+    /// Row filters tried by libpng
+    enum filter_type
+    {
+        FILTER_NONE,  ///< No filtering
+        FILTER_SUB,   ///< Difference from left pixel
+        FILTER_UP,    ///< Difference from pixel above
+        FILTER_AVG,   ///< Difference from average of left and above
+        FILTER_PAETH, ///< Paeth predictor
+        FILTER_ALL,   ///< Best of all filters, per row
+    };
+
+    /// Deflate strategies
+    enum strategy_type
+    {
+        STRATEGY_DEFAULT,  ///< Normal deflate
+        STRATEGY_FILTERED, ///< Tuned for filtered data
+        STRATEGY_HUFFMAN,  ///< Huffman coding only (no matching)
+        STRATEGY_RLE,      ///< Runs only (fast, suits flat tiles)
+        STRATEGY_FIXED,    ///< Fixed Huffman codes
+    };
+
+    /// Compression level (0 to 9)
+    int level = 6;
+
+    /// Row filter
+    filter_type filter = FILTER_ALL;
+
+    /// Deflate strategy
+    strategy_type strategy = STRATEGY_DEFAULT;
+
+    /**
+     * Parse Compression Level
+     *
+     * \param[in] text Compression level (0 to 9)
+     * \param[out] level Parsed level
+     * \return False if not a whole number from 0 to 9
+     */
+    static bool parse_level(const char *text, int &level);
+
+    /**
+     * Parse Filter Name
+     *
+     * \param[in] name Filter name (none, sub, up, avg, paeth or all)
+     * \param[out] filter Parsed filter
+     * \return False if name is not recognized
+     */
+    static bool parse_filter(const char *name, filter_type &filter);
+
+    /**
+     * Parse Strategy Name
+     *
+     * \param[in] name Strategy name (default, filtered, huffman, rle or fixed)
+     * \param[out] strategy Parsed strategy
+     * \return False if name is not recognized
+     */
+    static bool parse_strategy(const char *name, strategy_type &strategy);
+};
+
+/// PNG tile encoder
+class png_encoder
+{
+public:
+
+    /**
+     * Constructor
+     *
+     * \param[in] opts Encoder settings
+     */
+    png_encoder(const png_options &opts = png_options());
+
+    /**
+     * Get Encoder Settings
+     *
+     * \return Encoder settings
+     */
+    const png_options &options() const;
+
+    /**
+     * Encode Image
+     *
+     * Safe to call concurrently from multiple threads.
+     *
+     * \param[out] out PNG bytestream (replaced)
+     * \param[in] pixels Premultiplied ARGB32 pixels (cairo), by row
+     * \param[in] width Image width
+     * \param[in] height Image height
+     * \return False on encoder failure
+     */
+    bool encode(std::vector<uint8_t> &out, const uint32_t *pixels,
+                int width, int height) const;
+
+    /**
+     * Encode Indexed Image (PNG8)
+     *
+     * Safe to call concurrently from multiple threads.
+     *
+     * \param[out] out PNG bytestream (replaced)
+     * \param[in] indexes Palette indexes, by row
+     * \param[in] width Image width
+     * \param[in] height Image height
+     * \param[in] palette Color palette
+     * \return False on encoder failure
+     */
+    bool encode_indexed(std::vector<uint8_t> &out, const uint8_t *indexes,
+                        int width, int height, const color_palette &palette) const;
+
+private:
+
+    /// Encoder settings
+    png_options opts_;
+};
+
+}; // ~namespace encviz
@@ -67,6 +67,9 @@ struct layer_style
     /// Default render style
     simple_style style;
 
+    /// Clip margin around tile (pixels, default if not set)
+    std::optional<int> buffer;
+
     /// Attribute used for cutoffs
     std::string cutoff_attr;
 
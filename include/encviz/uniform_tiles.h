@@ -0,0 +1,85 @@
+#pragma once
+
+/**
+ * \file
+ * \brief Uniform Tile Table
+ *
+ * Many tiles (open water, solid land, no data) render to a single color. This
+ * detects such tiles, and keeps their encoded images so they are only encoded
+ * once per color and format, shared by all requests.
+ */
+
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace encviz
+{
+
+/// Shared table of encoded single color tiles
+class uniform_tiles
+{
+public:
+
+    /**
+     * Constructor
+     *
+     * \param[in] max_entries Maximum number of encoded tiles kept
+     */
+    uniform_tiles(std::size_t max_entries = 1024);
+
+    /**
+     * Check for Single Color
+     *
+     * \param[in] pixels ARGB32 pixels
+     * \param[in] count Number of pixels
+     * \param[out] pixel The color, if uniform
+     * \return False if more than one color
+     */
+    static bool is_uniform(const uint32_t *pixels, std::size_t count, uint32_t &pixel);
+
+    /**
+     * Find Encoded Tile
+     *
+     * Safe to call concurrently from multiple threads.
+     *
+     * \param[out] data Encoded image (replaced)
+     * \param[in] format Tile format (as integer)
+     * \param[in] pixel Tile color
+     * \return False if not in table
+     */
+    bool find(std::vector<uint8_t> &data, int format, uint32_t pixel) const;
+
+    /**
+     * Add Encoded Tile
+     *
+     * Safe to call concurrently from multiple threads. Ignored once table is
+     * full.
+     *
+     * \param[in] data Encoded image
+     * \param[in] format Tile format (as integer)
+     * \param[in] pixel Tile color
+     */
+    void insert(const std::vector<uint8_t> &data, int format, uint32_t pixel);
+
+    /**
+     * Get Number of Entries
+     *
+     * \return Encoded tiles in table
+     */
+    std::size_t size() const;
+
+private:
+
+    /// Maximum number of encoded tiles kept
+    std::size_t max_entries_;
+
+    /// Protects table
+    mutable std::shared_mutex mutex_;
+
+    /// Encoded tiles, by format (high word) and color (low word)
+    std::unordered_map<uint64_t, std::vector<uint8_t>> table_;
+};
+
+}; // ~namespace encviz
@@ -78,6 +78,31 @@ public:
      */
     coord pixels_to_meters(const coord &in) const;
 
+    /**
+     * Convert coordinate from degrees to pixels
+     *
+     * \param[in] in Input coordinate (degrees)
+     * \return Output coordinate (pixels)
+     */
+    coord deg_to_pixels(const coord &in) const;
+
+    /**
+     * Convert coordinates from degrees to pixels, in bulk
+     *
+     * Matches deg_to_pixels() to well under a pixel, but runs a vectorized
+     * kernel (picked at runtime for AVX-512, AVX2 or SSE2) over the whole
+     * span. Results near the poles (outside Web Mercator) are far off tile,
+     * but always finite.
+     *
+     * \param[in] x Input longitudes (degrees)
+     * \param[in] y Input latitudes (degrees)
+     * \param[in] count Number of coordinates
+     * \param[out] px Output columns (pixels)
+     * \param[out] py Output rows (pixels)
+     */
+    void deg_to_pixels(const double *x, const double *y, std::size_t count,
+                       double *px, double *py) const;
+
     /**
      * Convert OGR Point to pixels
      *
@@ -0,0 +1,64 @@
+#pragma once
+
+/**
+ * \file
+ * \brief WebP Encoder
+ *
+ * Encodes rendered tiles (cairo ARGB32 pixels) to lossless WebP, which is
+ * usually much smaller than PNG for flat shaded chart tiles. Only available
+ * when built with libwebp (HAVE_WEBP).
+ */
+
+#include <cstdint>
+#include <vector>
+
+namespace encviz
+{
+
+/// Lossless WebP tile encoder
+class webp_encoder
+{
+public:
+
+    /**
+     * Constructor
+     *
+     * \param[in] level Lossless effort preset (0 = fastest, 9 = smallest)
+     */
+    webp_encoder(int level = 6);
+
+    /**
+     * Check Encoder Availability
+     *
+     * \return False if built without libwebp
+     */
+    static bool available();
+
+    /**
+     * Get Effort Preset
+     *
+     * \return Lossless effort preset
+     */
+    int level() const;
+
+    /**
+     * Encode Image
+     *
+     * Safe to call concurrently from multiple threads.
+     *
+     * \param[out] out WebP bytestream (replaced)
+     * \param[in] pixels Premultiplied ARGB32 pixels (cairo), by row
+     * \param[in] width Image width
+     * \param[in] height Image height
+     * \return False on encoder failure (or if not available)
+     */
+    bool encode(std::vector<uint8_t> &out, const uint32_t *pixels,
+                int width, int height) const;
+
+private:
+
+    /// Lossless effort preset
+    int level_;
+};
+
+}; // ~namespace encviz
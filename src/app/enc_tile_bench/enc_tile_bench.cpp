@@ -0,0 +1,242 @@
+/**
+ * \file
+ * \brief ENC Tile Benchmark (Command Line)
+ *
+ * Renders a block of WTMS tiles once, then times encoding those same tiles
+ * with cairo's PNG writer, and with the tile encoders at a range of settings
+ * (32 bit and palette indexed PNG, and lossless WebP if built with libwebp),
+ * reporting throughput and output size of each.
+ */
+
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include <gdal.h>
+#include <encviz/enc_renderer.h>
+#include <encviz/png_encoder.h>
+#include <encviz/webp_encoder.h>
+
+/// Benchmarked encoder
+struct bench_encoder
+{
+    /// Display name
+    std::string name;
+
+    /// Encode one tile
+    std::function<bool(std::vector<uint8_t>&, const std::vector<uint32_t>&)> encode;
+};
+
+void usage(int exit_code)
+{
+    printf("Usage:\n"
+           "  enc_tile_bench [opts] <Z> <X0> <Y0> <X1> <Y1>\n"
+           "\n"
+           "Options:\n"
+           "  -h         - Show help\n"
+           "  -c <path>  - Set config directory (default=~/.config)\n"
+           "  -n <count> - Encode passes over all tiles (default=5)\n"
+           "  -s <name>  - Set render style (default=base-day)\n"
+           "\n"
+           "Where:\n"
+           "  Z          - Zoom tile coordinate\n"
+           "  X0, Y0     - First WTMS tile coordinates\n"
+           "  X1, Y1     - Last WTMS tile coordinates\n");
+    exit(exit_code);
+}
+
+/**
+ * Cairo Stream Callback
+ *
+ * \param[out] closure Pointer to std::vector<uint8_t> output stream
+ * \param[in] data Data buffer
+ * \param[in] length Length of data buffer
+ */
+static cairo_status_t cairo_write_to_vector(void *closure,
+                                            const unsigned char *data,
+                                            unsigned int length)
+{
+    std::vector<uint8_t> *output = (std::vector<uint8_t>*)closure;
+    output->insert(output->end(), data, data + length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    const char *config_path = nullptr;
+    const char *style_name = "base-day";
+    int passes = 5;
+
+    // Parse args
+    while ((opt = getopt(argc, argv, "hc:n:s:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'h':
+                // Help text
+                usage(0);
+                break;
+
+            case 'c':
+                // Set config path
+                config_path = optarg;
+                break;
+
+            case 'n':
+                // Set encode passes
+                passes = std::max(1, atoi(optarg));
+                break;
+
+            case 's':
+                // Set style name
+                style_name = optarg;
+                break;
+
+            default:
+                // Invalid arg / missing argument
+                usage(1);
+                break;
+        }
+    }
+    if ((argc - optind) < 5)
+    {
+        usage(1);
+    }
+    int z = atoi(argv[optind + 0]);
+    int x0 = atoi(argv[optind + 1]);
+    int y0 = atoi(argv[optind + 2]);
+    int x1 = atoi(argv[optind + 3]);
+    int y1 = atoi(argv[optind + 4]);
+
+    // Global GDAL Initialization
+    GDALAllRegister();
+    encviz::enc_renderer enc_rend(config_path);
+    int tile_size = enc_rend.get_tile_size();
+
+    // Render tiles once
+    std::vector<std::vector<uint32_t>> tiles;
+    auto start = std::chrono::steady_clock::now();
+    for (int y = y0; y <= y1; y++)
+    {
+        for (int x = x0; x <= x1; x++)
+        {
+            std::vector<uint32_t> pixels;
+            if (enc_rend.render_pixels(pixels, encviz::tile_coords::WTMS, x, y, z, style_name))
+            {
+                tiles.push_back(std::move(pixels));
+            }
+        }
+    }
+    double render_s = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    if (tiles.empty())
+    {
+        printf("No tiles rendered\n");
+        return 1;
+    }
+    printf("Rendered %lu tiles (%.2f ms/tile)\n\n", tiles.size(),
+           1e3 * render_s / tiles.size());
+
+    // Encoders to compare
+    std::vector<bench_encoder> encoders;
+    encoders.push_back({ "cairo", [&](std::vector<uint8_t> &out,
+                                      const std::vector<uint32_t> &pixels) {
+        cairo_surface_t *surface = cairo_image_surface_create_for_data(
+            (unsigned char*)pixels.data(), CAIRO_FORMAT_ARGB32, tile_size, tile_size,
+            tile_size * sizeof(uint32_t));
+        out.clear();
+        cairo_status_t rc = cairo_surface_write_to_png_stream(surface, cairo_write_to_vector,
+                                                              &out);
+        cairo_surface_destroy(surface);
+        return rc == CAIRO_STATUS_SUCCESS;
+    } });
+    const encviz::png_encoder &configured = enc_rend.get_png_encoder();
+    encoders.push_back({ "configured", [&](std::vector<uint8_t> &out,
+                                           const std::vector<uint32_t> &pixels) {
+        return configured.encode(out, pixels.data(), tile_size, tile_size);
+    } });
+    const encviz::color_palette *palette = enc_rend.get_palette(style_name);
+    for (int level : { 1, 6, 9 })
+    {
+        encviz::png_options opts = configured.options();
+        opts.level = level;
+        encviz::png_encoder encoder(opts);
+        encoders.push_back({ "png8 level=" + std::to_string(level),
+                             [encoder, palette, tile_size](std::vector<uint8_t> &out,
+                                                           const std::vector<uint32_t> &pixels) {
+            thread_local std::vector<uint8_t> indexes;
+            palette->quantize(indexes, pixels.data(), pixels.size());
+            return encoder.encode_indexed(out, indexes.data(), tile_size, tile_size, *palette);
+        } });
+    }
+    for (int level : { 0, 3, 6, 9 })
+    {
+        if (!encviz::webp_encoder::available())
+        {
+            break;
+        }
+        encviz::webp_encoder encoder(level);
+        encoders.push_back({ "webp level=" + std::to_string(level),
+                             [encoder, tile_size](std::vector<uint8_t> &out,
+                                                  const std::vector<uint32_t> &pixels) {
+            return encoder.encode(out, pixels.data(), tile_size, tile_size);
+        } });
+    }
+    const char *filters[] = { "none", "up", "all" };
+    const char *strategies[] = { "default", "rle" };
+    for (int level : { 1, 6, 9 })
+    {
+        for (const char *strategy : strategies)
+        {
+            for (const char *filter : filters)
+            {
+                encviz::png_options opts;
+                opts.level = level;
+                encviz::png_options::parse_filter(filter, opts.filter);
+                encviz::png_options::parse_strategy(strategy, opts.strategy);
+                encviz::png_encoder encoder(opts);
+                encoders.push_back({ "png level=" + std::to_string(level) + " filter=" +
+                                     filter + " strategy=" + strategy,
+                                     [encoder, tile_size](std::vector<uint8_t> &out,
+                                                          const std::vector<uint32_t> &pixels) {
+                    return encoder.encode(out, pixels.data(), tile_size, tile_size);
+                } });
+            }
+        }
+    }
+
+    // Time each encoder over all tiles
+    double raw_mb = (double)tiles.size() * tile_size * tile_size * sizeof(uint32_t) / (1 << 20);
+    printf("%-42s %10s %10s %12s\n", "Encoder", "ms/tile", "MB/s", "avg bytes");
+    std::vector<uint8_t> out;
+    for (const bench_encoder &encoder : encoders)
+    {
+        std::size_t bytes = 0;
+        start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; pass++)
+        {
+            for (const std::vector<uint32_t> &pixels : tiles)
+            {
+                if (!encoder.encode(out, pixels))
+                {
+                    printf("%s: encode failed\n", encoder.name.c_str());
+                    return 1;
+                }
+                bytes += out.size();
+            }
+        }
+        double encode_s = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        printf("%-42s %10.3f %10.1f %12lu\n", encoder.name.c_str(),
+               1e3 * encode_s / (passes * tiles.size()),
+               passes * raw_mb / encode_s, bytes / (passes * tiles.size()));
+    }
+
+    GDALDestroy();
+    return 0;
+}
@@ -3,15 +3,21 @@
  * \brief ENC Tile Server (WMTS)
  *
  * Minimal WMTS style tile server to dynamically render ENC(S-57) chart data
- * to PNG files, delivered over HTTP port 8888.
+ * to PNG or WebP files, delivered over HTTP port 8888.
  *
  * NOTE: Set your tile server to:
  *   http://127.0.0.1:8888/<STYLE>/{z}/{y}/{x}.png
  *
  * Where "STYLE" is one of the defined chart styles (ie - "default"), and X/Y/Z
- * refer to the WTMS tile coordinates.
+ * refer to the WTMS tile coordinates. Use ".webp" for lossless WebP tiles, or
+ * leave off the extension to get WebP only if the client Accepts it.
+ *
+ * When started with "-m", export statistics summed over all requests are
+ * served at:
+ *   http://127.0.0.1:8888/stats
  */
 
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -19,11 +25,29 @@
 #include <sys/types.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <mutex>
 #include <microhttpd.h>
+#include <encdata/logger.h>
 #include <encviz/enc_renderer.h>
 
 #define PORT 8888
 
+/// Server state shared by request threads
+struct server_context
+{
+    /// ENC renderer
+    encviz::enc_renderer *renderer;
+
+    /// Collect export statistics
+    bool collect_stats;
+
+    /// Protects statistics totals
+    std::mutex stats_mutex;
+
+    /// Export statistics, summed over all requests
+    encdata::export_stats stats_total;
+};
+
 void usage(int exit_code)
 {
     printf("Usage:\n"
@@ -32,6 +56,8 @@ void usage(int exit_code)
            "Options:\n"
            "  -h         - Show help\n"
            "  -c <path>  - Set config directory (default=~/.config)\n"
+           "  -l <level> - Log level (debug, info, warn, error; default=info)\n"
+           "  -m         - Collect export statistics (served at /stats)\n"
            "  -s         - Single threaded operation\n");
     exit(exit_code);
 }
@@ -50,71 +76,175 @@ std::vector<std::string> string_split(std::string input)
     return tokens;
 }
 
-MHD_Result request_reply(MHD_Connection *conn, int code, const void *data, int len)
+// Pick tile format from file extension (removed from tile), or from the
+// Accept header if there is none. False if extension is not supported.
+bool pick_format(MHD_Connection *conn, std::string &tile, encviz::tile_format default_format,
+                 encviz::tile_format &format, bool &negotiated)
+{
+    // Configured PNG flavor, for clients that want PNG
+    encviz::tile_format png_format = (default_format == encviz::tile_format::WEBP) ?
+        encviz::tile_format::PNG : default_format;
+
+    size_t pos = tile.find('.');
+    negotiated = (pos == std::string::npos);
+    if (!negotiated)
+    {
+        std::string ext = tile.substr(pos + 1);
+        tile = tile.substr(0, pos);
+        if (ext == "png")
+        {
+            format = png_format;
+            return true;
+        }
+        format = encviz::tile_format::WEBP;
+        return (ext == "webp") && encviz::enc_renderer::supports_format(format);
+    }
+
+    const char *accept = MHD_lookup_connection_value(conn, MHD_HEADER_KIND,
+                                                     MHD_HTTP_HEADER_ACCEPT);
+    bool webp_ok = (accept != nullptr) && (strstr(accept, "image/webp") != nullptr) &&
+        encviz::enc_renderer::supports_format(encviz::tile_format::WEBP);
+    format = webp_ok ? encviz::tile_format::WEBP : png_format;
+    return true;
+}
+
+MHD_Result request_reply(MHD_Connection *conn, int code, const void *data, int len,
+                         const char *content_type = nullptr, bool vary_accept = false)
 {
     MHD_Response *resp = MHD_create_response_from_buffer(len, (void*)data, MHD_RESPMEM_MUST_COPY);
+    if (content_type != nullptr)
+    {
+        MHD_add_response_header(resp, MHD_HTTP_HEADER_CONTENT_TYPE, content_type);
+    }
+    if (vary_accept)
+    {
+        // Same URL gives different formats, so caches must key on Accept too
+        MHD_add_response_header(resp, MHD_HTTP_HEADER_VARY, MHD_HTTP_HEADER_ACCEPT);
+    }
     MHD_Result ret = MHD_queue_response(conn, code, resp);
     MHD_destroy_response(resp);
-    printf(" - HTTP %d\n", code);
     return ret;
 }
 
+void log_access(const char *method, const char *url, int code, std::size_t len,
+                std::chrono::steady_clock::time_point start,
+                const encdata::export_stats *stats)
+{
+    if (!encdata::logger::get().enabled(encdata::log_level::INFO))
+    {
+        return;
+    }
+
+    // Export stage timings, when collected
+    char timings[256] = "";
+    if (stats != nullptr)
+    {
+        int used = 0;
+        for (int i = 0; i < encdata::export_stats::STAGE_COUNT; i++)
+        {
+            used += snprintf(timings + used, sizeof(timings) - used, " %s_ms=%.3f",
+                             encdata::export_stats::stage_name((encdata::export_stats::stage)i),
+                             stats->stage_ns[i] / 1e6);
+        }
+    }
+
+    double total_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("access method=%s url=%s status=%d bytes=%lu total_ms=%.3f%s",
+             method, url, code, (unsigned long)len, total_ms, timings);
+}
+
 MHD_Result request_handler(void *cls, struct MHD_Connection *connection,
 			   const char *url, const char *method,
 			   const char *version, const char *upload_data,
 			   size_t *upload_data_size, void **req_cls)
 {
+    // Get server state
+    server_context *ctx = (server_context*)cls;
+    auto start = std::chrono::steady_clock::now();
+
     // Parse URL
-    printf("URL: %s\n", url);
+    LOG_DEBUG("URL: %s", url);
     std::vector<std::string> tokens = string_split(url);
+    if ((tokens.size() == 2) && (tokens[1] == "stats") && ctx->collect_stats)
+    {
+        // Report statistics so far
+        std::string text;
+        {
+            std::lock_guard<std::mutex> lock(ctx->stats_mutex);
+            text = ctx->stats_total.to_string();
+        }
+        log_access(method, url, MHD_HTTP_OK, text.size(), start, nullptr);
+        return request_reply(connection, MHD_HTTP_OK, text.data(), text.size());
+    }
     if (tokens.size() != 5)
     {
 	const char *msg = "Invalid URL";
+        log_access(method, url, MHD_HTTP_BAD_REQUEST, strlen(msg), start, nullptr);
 	return request_reply(connection, MHD_HTTP_BAD_REQUEST,
 			     msg, strlen(msg));
     }
+    encviz::tile_format format;
+    bool negotiated;
+    if (!pick_format(connection, tokens[4], ctx->renderer->get_tile_format(),
+                     format, negotiated))
+    {
+        const char *msg = "Unsupported tile format";
+        log_access(method, url, MHD_HTTP_NOT_FOUND, strlen(msg), start, nullptr);
+        return request_reply(connection, MHD_HTTP_NOT_FOUND, msg, strlen(msg));
+    }
     std::string style_name = tokens[1];
     int z = std::stoi(tokens[2]);
     int y = std::stoi(tokens[3]);
     int x = std::stoi(tokens[4]);
 
-    // Get passed SQLite DB
-    encviz::enc_renderer *enc_rend = (encviz::enc_renderer*)cls;
-
-    // Render requested tile
+    // Render requested tile, timing export stages for the access log too
     std::vector<uint8_t> out_bytes;
-    printf("Tile X=%d, Y=%d, Z=%d\n", x, y, z);
+    encdata::export_stats stats;
+    bool want_stats = ctx->collect_stats ||
+        encdata::logger::get().enabled(encdata::log_level::INFO);
+    LOG_DEBUG("Tile X=%d, Y=%d, Z=%d", x, y, z);
+    int code;
     try
     {
-        if (enc_rend->render(out_bytes, encviz::tile_coords::WTMS, x, y, z,
-                             style_name.c_str()))
+        bool ok = ctx->renderer->render(out_bytes, format, encviz::tile_coords::WTMS,
+                                        x, y, z, style_name.c_str(),
+                                        want_stats ? &stats : nullptr);
+        if (ctx->collect_stats)
         {
-            // Respond with rendered data
-            return request_reply(connection, MHD_HTTP_OK,
-                                 out_bytes.data(), out_bytes.size());
+            std::lock_guard<std::mutex> lock(ctx->stats_mutex);
+            ctx->stats_total.add(stats);
         }
-        else
+
+        // Respond with rendered data, or 404 if nothing available
+        code = ok ? MHD_HTTP_OK : MHD_HTTP_NOT_FOUND;
+        if (!ok)
         {
-            // Nothing available, so 404 ...
-            return request_reply(connection, MHD_HTTP_NOT_FOUND,
-                                 nullptr, 0);
+            out_bytes.clear();
         }
     }
     catch (std::exception &e)
     {
         // Exception thrown
-        return request_reply(connection, MHD_HTTP_INTERNAL_SERVER_ERROR,
-                             nullptr, 0);
+        LOG_ERROR("Render failed (%s): %s", url, e.what());
+        code = MHD_HTTP_INTERNAL_SERVER_ERROR;
+        out_bytes.clear();
     }
+    log_access(method, url, code, out_bytes.size(), start, want_stats ? &stats : nullptr);
+    const char *content_type = (format == encviz::tile_format::WEBP) ? "image/webp" : "image/png";
+    return request_reply(connection, code, out_bytes.data(), out_bytes.size(),
+                         (code == MHD_HTTP_OK) ? content_type : nullptr, negotiated);
 }
 
 int main(int argc, char **argv)
 {
     int opt, mhd_mode = MHD_USE_THREAD_PER_CONNECTION;
     const char *config_path = nullptr;
+    bool collect_stats = false;
+    encdata::log_level log_level;
 
     // Parse args
-    while ((opt = getopt(argc, argv, "hc:s")) != -1)
+    while ((opt = getopt(argc, argv, "hc:l:ms")) != -1)
     {
         switch (opt)
         {
@@ -128,6 +258,20 @@ int main(int argc, char **argv)
                 config_path = optarg;
                 break;
 
+            case 'l':
+                // Set log level
+                if (!encdata::logger::parse_level(optarg, log_level))
+                {
+                    usage(1);
+                }
+                encdata::logger::get().set_level(log_level);
+                break;
+
+            case 'm':
+                // Collect export statistics
+                collect_stats = true;
+                break;
+
             case 's':
                 mhd_mode = MHD_USE_INTERNAL_POLLING_THREAD;
                 break;
@@ -144,11 +288,14 @@ int main(int argc, char **argv)
 
     // ENC renderer context
     encviz::enc_renderer enc_rend(config_path);
+    server_context ctx;
+    ctx.renderer = &enc_rend;
+    ctx.collect_stats = collect_stats;
 
     // Start MHD
     MHD_Daemon *daemon = MHD_start_daemon(MHD_USE_AUTO | mhd_mode,
                                           PORT, NULL, NULL,
-                                          &request_handler, &enc_rend, MHD_OPTION_END);
+                                          &request_handler, &ctx, MHD_OPTION_END);
     if (daemon == nullptr)
     {
         printf("FATAL - Could not start server (port in use?)\n");
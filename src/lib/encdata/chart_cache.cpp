@@ -0,0 +1,184 @@
+/**
+ * \file
+ * \brief ENC Chart Cache
+ *
+ * Byte budgeted LRU cache of opened ENC(S-57) chart datasets, so charts used
+ * by neighboring tiles are not reopened and reparsed for every request.
+ */
+
+#include <stdexcept>
+#include <encdata/chart_cache.h>
+
+namespace encdata
+{
+
+/// Approximate in-memory size of an opened S57 dataset, relative to its files
+static constexpr std::size_t memory_factor = 4;
+
+/**
+ * Constructor
+ *
+ * \param[in] cache Owning cache
+ * \param[in] item Leased dataset
+ */
+chart_cache::handle::handle(chart_cache *cache, entry &&item)
+    : cache_(cache), item_(std::move(item))
+{
+}
+
+/**
+ * Destructor (returns dataset to cache)
+ */
+chart_cache::handle::~handle()
+{
+    if ((cache_ != nullptr) && item_.ds)
+    {
+        cache_->release(std::move(item_));
+    }
+}
+
+/**
+ * Get Dataset
+ *
+ * \return Leased dataset
+ */
+GDALDataset *chart_cache::handle::get() const
+{
+    return item_.ds.get();
+}
+
+/**
+ * Constructor
+ *
+ * \param[in] budget Size budget for idle datasets (bytes)
+ */
+chart_cache::chart_cache(std::size_t budget)
+    : budget_(budget), bytes_(0), hits_(0), misses_(0), evictions_(0)
+{
+}
+
+/**
+ * Set Size Budget
+ *
+ * \param[in] budget Size budget for idle datasets (bytes)
+ */
+void chart_cache::set_budget(std::size_t budget)
+{
+    std::list<entry> evicted;
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = budget;
+    evict(evicted);
+}
+
+/**
+ * Open Chart Dataset
+ *
+ * \param[in] chart Chart to open
+ * \return Exclusive lease of dataset
+ */
+chart_cache::handle chart_cache::open(const chart_metadata &chart)
+{
+    // Fingerprint is part of identity, so updated charts are never served
+    // from stale datasets
+    std::string key = chart.path.string() + ":" + std::to_string(chart.file_time);
+
+    // Take an idle dataset, if there is one
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = idle_.find(key);
+        if (it != idle_.end())
+        {
+            auto pos = it->second;
+            entry item = std::move(*pos);
+            idle_.erase(it);
+            lru_.erase(pos);
+            bytes_ -= item.bytes;
+            hits_++;
+            return handle(this, std::move(item));
+        }
+    }
+
+    // Otherwise open a new one (outside of lock)
+    misses_++;
+    const char *const drivers[] = { "S57", nullptr };
+    entry item;
+    item.key = key;
+    item.bytes = std::max<std::size_t>(chart.file_size, 1) * memory_factor;
+    item.ds.reset(GDALDataset::Open(chart.path.string().c_str(),
+                                    GDAL_OF_VECTOR | GDAL_OF_READONLY,
+                                    drivers, nullptr, nullptr));
+    if (!item.ds)
+    {
+        throw std::runtime_error("Cannot open input data set");
+    }
+    return handle(this, std::move(item));
+}
+
+/**
+ * Close All Idle Datasets
+ */
+void chart_cache::clear()
+{
+    std::list<entry> evicted;
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.clear();
+    evicted.swap(lru_);
+    bytes_ = 0;
+}
+
+/**
+ * Get Cache Counters
+ *
+ * \return Current counters
+ */
+chart_cache::stats chart_cache::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return { hits_, misses_, evictions_, lru_.size(), bytes_ };
+}
+
+/**
+ * Return Dataset to Cache
+ *
+ * \param[in] item Dataset to return
+ */
+void chart_cache::release(entry &&item)
+{
+    // Declared before lock, so evicted datasets are closed after unlocking
+    std::list<entry> evicted;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    bytes_ += item.bytes;
+    lru_.push_front(std::move(item));
+    idle_.emplace(lru_.front().key, lru_.begin());
+    evict(evicted);
+}
+
+/**
+ * Evict Datasets Over Budget (mutex held)
+ *
+ * \param[out] evicted Evicted datasets, to close once unlocked
+ */
+void chart_cache::evict(std::list<entry> &evicted)
+{
+    while ((bytes_ > budget_) && !lru_.empty())
+    {
+        // Remove least recently used from lookup
+        auto pos = std::prev(lru_.end());
+        auto range = idle_.equal_range(pos->key);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == pos)
+            {
+                idle_.erase(it);
+                break;
+            }
+        }
+
+        bytes_ -= pos->bytes;
+        evicted.splice(evicted.end(), lru_, pos);
+        evictions_++;
+    }
+}
+
+}; // ~namespace encdata
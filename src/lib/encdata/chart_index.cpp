@@ -0,0 +1,185 @@
+/**
+ * \file
+ * \brief ENC Chart Index
+ *
+ * Packed (STR bulk loaded) R-tree of chart coverage bounds, used to quickly
+ * select charts for a bounding box and minimum compilation scale.
+ */
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <encdata/chart_index.h>
+
+namespace encdata
+{
+
+/// Traversal stack limit (tree height of 8 is sufficient for 2^32 entries)
+static constexpr std::size_t stack_limit = 128;
+
+/**
+ * Build Index
+ *
+ * Entries are expected to be presorted in ascending scale order (most
+ * detailed first), as query results are returned in entry order.
+ *
+ * \param[in] entries Charts to index
+ */
+void chart_index::build(const std::vector<entry> &entries)
+{
+    clear();
+    if (entries.size() > std::numeric_limits<uint32_t>::max())
+    {
+        throw std::runtime_error("Too many charts to index");
+    }
+    entries_ = entries;
+    if (entries_.empty())
+    {
+        return;
+    }
+
+    // Pack entries into leaves, then each level above until one root remains
+    std::vector<uint32_t> items(entries_.size());
+    std::iota(items.begin(), items.end(), 0);
+    bool leaf = true;
+    do
+    {
+        items = pack(items, leaf);
+        leaf = false;
+    }
+    while (items.size() > 1);
+}
+
+/**
+ * Clear Index
+ */
+void chart_index::clear()
+{
+    nodes_.clear();
+    links_.clear();
+    entries_.clear();
+}
+
+/**
+ * Query Index
+ *
+ * Finds all charts intersecting the bounding box with a compilation scale
+ * of at least scale_min. Results are entry indices in ascending order,
+ * which is also most detailed first. No allocation is performed if the
+ * results vector already has sufficient capacity.
+ *
+ * \param[out] results Matching entry indices
+ * \param[in] bbox Query bounding box (deg)
+ * \param[in] scale_min Minimum data compilation scale
+ */
+void chart_index::query(std::vector<std::size_t> &results, const OGREnvelope &bbox,
+                        int scale_min) const
+{
+    results.clear();
+    if (nodes_.empty())
+    {
+        return;
+    }
+
+    // Depth first traversal from root, pruning by both bounds and scale
+    uint32_t stack[stack_limit];
+    std::size_t depth = 0;
+    stack[depth++] = nodes_.size() - 1;
+    while (depth > 0)
+    {
+        const node &next = nodes_[stack[--depth]];
+        if ((next.scale_max < scale_min) || !bbox.Intersects(next.bbox))
+        {
+            continue;
+        }
+
+        for (uint32_t i = next.first; i < next.first + next.count; i++)
+        {
+            uint32_t child = links_[i];
+            if (!next.leaf)
+            {
+                stack[depth++] = child;
+            }
+            else if ((scale_min <= entries_[child].scale) &&
+                     bbox.Intersects(entries_[child].bbox))
+            {
+                results.push_back(child);
+            }
+        }
+    }
+
+    // Entries are in scale order, so this is also most detailed first
+    std::sort(results.begin(), results.end());
+}
+
+/**
+ * Get Indexed Entry Count
+ *
+ * \return Number of indexed charts
+ */
+std::size_t chart_index::size() const
+{
+    return entries_.size();
+}
+
+/**
+ * Pack One Tree Level
+ *
+ * \param[in] items Item indices to pack (sorted in place)
+ * \param[in] leaf Items are entries, not nodes
+ * \return Indices of created nodes
+ */
+std::vector<uint32_t> chart_index::pack(std::vector<uint32_t> &items, bool leaf)
+{
+    // Item accessors, whether packing entries or nodes
+    auto bbox_of = [&](uint32_t i) -> const OGREnvelope & {
+        return leaf ? entries_[i].bbox : nodes_[i].bbox;
+    };
+    auto scale_of = [&](uint32_t i) {
+        return leaf ? entries_[i].scale : nodes_[i].scale_max;
+    };
+    auto by_x = [&](uint32_t a, uint32_t b) {
+        return (bbox_of(a).MinX + bbox_of(a).MaxX) < (bbox_of(b).MinX + bbox_of(b).MaxX);
+    };
+    auto by_y = [&](uint32_t a, uint32_t b) {
+        return (bbox_of(a).MinY + bbox_of(a).MaxY) < (bbox_of(b).MinY + bbox_of(b).MaxY);
+    };
+
+    // Sort-Tile-Recursive: cut into vertical slices by X, then group by Y
+    std::size_t node_count = (items.size() + fanout - 1) / fanout;
+    std::size_t slice_count = (std::size_t)std::ceil(std::sqrt((double)node_count));
+    std::size_t slice_size = slice_count * fanout;
+    std::sort(items.begin(), items.end(), by_x);
+
+    std::vector<uint32_t> created;
+    for (std::size_t start = 0; start < items.size(); start += slice_size)
+    {
+        std::size_t stop = std::min(start + slice_size, items.size());
+        std::sort(items.begin() + start, items.begin() + stop, by_y);
+
+        // Each run of (up to) fanout items becomes a node
+        for (std::size_t i = start; i < stop; i += fanout)
+        {
+            node next;
+            next.scale_max = std::numeric_limits<int>::min();
+            next.first = links_.size();
+            next.count = std::min(fanout, stop - i);
+            next.leaf = leaf;
+            for (std::size_t j = i; j < i + next.count; j++)
+            {
+                links_.push_back(items[j]);
+                next.bbox.Merge(bbox_of(items[j]));
+                next.scale_max = std::max(next.scale_max, scale_of(items[j]));
+            }
+
+            created.push_back(nodes_.size());
+            nodes_.push_back(next);
+        }
+    }
+
+    return created;
+}
+
+}; // ~namespace encdata
@@ -0,0 +1,706 @@
+/**
+ * \file
+ * \brief ENC Chart Store
+ *
+ * Compact, memory mapped, columnar copy of an ENC(S-57) chart. Each layer
+ * keeps per-feature bounding boxes, coordinates as contiguous arrays, and
+ * numeric attributes only (all that styles can use for cutoffs), so data
+ * can be extracted without going through the GDAL S57 driver. Line and area
+ * layers are also kept simplified for a few scale bands, so small scale
+ * tiles need not handle full resolution geometry.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <unistd.h>
+#include <encdata/chart_store.h>
+
+namespace encdata
+{
+
+/// File identifier
+static const char file_magic[8] = { 'E', 'N', 'C', 'S', 'T', 'O', 'R', 'E' };
+
+/// Maximum stored name length (layers and attributes)
+static constexpr std::size_t name_size = 16;
+
+/// Smallest presentation scale of each generalization band
+static const int band_scales[chart_store::band_count] = { 0, 200000, 800000, 3200000 };
+
+/// Standard display pixel size (m), as used for WMTS scale denominators
+static constexpr double pixel_size = 0.00028;
+
+/// Simplification tolerance, in display pixels at a band's minimum scale
+static constexpr double band_pixels = 0.25;
+
+/// Approximate meters per degree (latitude)
+static constexpr double meters_per_deg = 111320;
+
+/// File header (on disk)
+struct file_header
+{
+    /// File identifier
+    char magic[8];
+
+    /// File format version
+    uint32_t version;
+
+    /// Number of layer headers (following file header)
+    uint32_t layer_count;
+
+    /// Source chart size (bytes)
+    uint64_t file_size;
+
+    /// Source chart modification time (ns)
+    int64_t file_time;
+};
+
+/// Layer header (on disk)
+struct layer_header
+{
+    /// Layer name
+    char name[name_size];
+
+    /// Number of features
+    uint32_t feature_count;
+
+    /// Number of geometry parts
+    uint32_t part_count;
+
+    /// Number of coordinates
+    uint32_t coord_count;
+
+    /// Number of numeric attributes
+    uint32_t attr_count;
+
+    /// Coordinates include Z values
+    uint32_t has_z;
+
+    /// Generalization band
+    uint32_t band;
+
+    /// Offset to feature records
+    uint64_t features_offset;
+
+    /// Offset to geometry parts
+    uint64_t parts_offset;
+
+    /// Offset to coordinates (X array, Y array, then Z array if present)
+    uint64_t coords_offset;
+
+    /// Offset to attributes (names, then values by attribute)
+    uint64_t attrs_offset;
+};
+
+/// Layer contents, while writing
+struct layer_data
+{
+    /// Layer name
+    std::string name;
+
+    /// Generalization band
+    std::size_t band = 0;
+
+    /// Any geometry has Z values
+    bool has_z = false;
+
+    /// Feature records
+    std::vector<chart_store::feature> features;
+
+    /// Geometry parts
+    std::vector<chart_store::part> parts;
+
+    /// Coordinates
+    std::vector<double> x, y, z;
+
+    /// Source field index of each numeric attribute
+    std::vector<int> fields;
+
+    /// Numeric attribute names
+    std::vector<std::string> attr_names;
+
+    /// Attribute values, by attribute then feature
+    std::vector<std::vector<double>> attr_values;
+};
+
+/**
+ * Copy Name to Fixed Field
+ *
+ * \param[out] out Output field
+ * \param[in] in Input name
+ * \return False if name is too long
+ */
+static bool pack_name(char out[name_size], const std::string &in)
+{
+    if (in.size() >= name_size)
+    {
+        return false;
+    }
+    memset(out, 0, name_size);
+    memcpy(out, in.data(), in.size());
+    return true;
+}
+
+/**
+ * Fixed Field to Name
+ *
+ * \param[in] in Input field
+ * \return Output name
+ */
+static std::string unpack_name(const char in[name_size])
+{
+    return std::string(in, strnlen(in, name_size));
+}
+
+/**
+ * Read Layer Contents
+ *
+ * \param[in] layer Chart layer
+ * \param[in] band Generalization band
+ * \return Layer contents
+ */
+static layer_data read_layer(OGRLayer *layer, std::size_t band)
+{
+    layer_data data;
+    data.name = layer->GetName();
+    data.band = band;
+    double tolerance = chart_store::band_tolerance(band);
+
+    // Keep only numeric attributes
+    OGRFeatureDefn *defn = layer->GetLayerDefn();
+    for (int i = 0; i < defn->GetFieldCount(); i++)
+    {
+        OGRFieldType type = defn->GetFieldDefn(i)->GetType();
+        if ((type == OFTInteger) || (type == OFTInteger64) || (type == OFTReal))
+        {
+            data.fields.push_back(i);
+            data.attr_names.push_back(defn->GetFieldDefn(i)->GetNameRef());
+        }
+    }
+    data.attr_values.resize(data.fields.size());
+
+    // Copy features having geometry
+    layer->ResetReading();
+    for (auto &feat : layer)
+    {
+        const OGRGeometry *geo = feat->GetGeometryRef();
+        if (geo == nullptr)
+        {
+            continue;
+        }
+
+        // Simplify lines and areas, keeping the original if nothing is left
+        // (each on its own, shared edges are only kept within tolerance)
+        std::unique_ptr<OGRGeometry> simple;
+        OGRwkbGeometryType gtype = wkbFlatten(geo->getGeometryType());
+        if ((tolerance > 0) && (gtype != wkbPoint) && (gtype != wkbMultiPoint))
+        {
+            simple.reset(geo->SimplifyPreserveTopology(tolerance));
+            if (simple && !simple->IsEmpty())
+            {
+                geo = simple.get();
+            }
+        }
+
+        chart_store::feature next = {};
+        OGREnvelope bbox;
+        geo->getEnvelope(&bbox);
+        next.bbox[0] = bbox.MinX;
+        next.bbox[1] = bbox.MaxX;
+        next.bbox[2] = bbox.MinY;
+        next.bbox[3] = bbox.MaxY;
+        next.geom_type = geo->getGeometryType();
+        next.part_first = data.parts.size();
+        data.has_z = data.has_z || geo->Is3D();
+        add_geometry_parts(data.parts, data.x, data.y, data.z, *geo);
+        next.part_count = data.parts.size() - next.part_first;
+        data.features.push_back(next);
+
+        for (std::size_t i = 0; i < data.fields.size(); i++)
+        {
+            data.attr_values[i].push_back(
+                feat->IsFieldSetAndNotNull(data.fields[i]) ?
+                feat->GetFieldAsDouble(data.fields[i]) :
+                std::numeric_limits<double>::quiet_NaN());
+        }
+    }
+
+    if (!data.has_z)
+    {
+        data.z.clear();
+    }
+    return data;
+}
+
+/**
+ * Append Array to Buffer
+ *
+ * \param[out] out Output buffer
+ * \param[in] data Array data
+ * \param[in] count Number of elements
+ */
+template <typename T>
+static void append(std::string &out, const T *data, std::size_t count)
+{
+    out.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+}
+
+/**
+ * Get Band Minimum Scale
+ *
+ * \param[in] band Generalization band
+ * \return Smallest presentation scale band is used for
+ */
+int chart_store::band_scale(std::size_t band)
+{
+    return band_scales[band];
+}
+
+/**
+ * Get Band Simplification Tolerance
+ *
+ * A quarter of a display pixel at the band's minimum scale. Features are
+ * simplified one at a time, so edges shared by neighbouring areas may move
+ * apart by up to twice this, which must stay under a pixel to not show as
+ * slivers or gaps.
+ *
+ * \param[in] band Generalization band
+ * \return Simplification tolerance (deg)
+ */
+double chart_store::band_tolerance(std::size_t band)
+{
+    return band_scales[band] * band_pixels * pixel_size / meters_per_deg;
+}
+
+/**
+ * Get Feature Bounding Box
+ *
+ * \param[in] idx Feature index
+ * \return Bounding box (deg)
+ */
+OGREnvelope chart_store::layer::bbox(std::size_t idx) const
+{
+    OGREnvelope out;
+    out.MinX = features[idx].bbox[0];
+    out.MaxX = features[idx].bbox[1];
+    out.MinY = features[idx].bbox[2];
+    out.MaxY = features[idx].bbox[3];
+    return out;
+}
+
+/**
+ * Get Attribute Value
+ *
+ * \param[in] attr Attribute index
+ * \param[in] idx Feature index
+ * \return Attribute value (NaN if unset)
+ */
+double chart_store::layer::attr(std::size_t attr, std::size_t idx) const
+{
+    return attr_values[attr * feature_count + idx];
+}
+
+/**
+ * Find Attribute
+ *
+ * \param[in] name Attribute name
+ * \return Attribute index, or -1 if not present
+ */
+int chart_store::layer::find_attr(const char *name) const
+{
+    for (std::size_t i = 0; i < attr_names.size(); i++)
+    {
+        if (attr_names[i] == name)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Build Feature Geometry
+ *
+ * \param[in] idx Feature index
+ * \return New OGR geometry
+ */
+std::unique_ptr<OGRGeometry> chart_store::layer::geometry(std::size_t idx) const
+{
+    const feature &feat = features[idx];
+
+    // Rebuild simple geometries from parts
+    std::vector<std::unique_ptr<OGRGeometry>> pieces;
+    for (uint32_t i = feat.part_first; i < feat.part_first + feat.part_count; i++)
+    {
+        const part &next = parts[i];
+        const double *px = x + next.coord_first;
+        const double *py = y + next.coord_first;
+        const double *pz = (z != nullptr) ? z + next.coord_first : nullptr;
+        switch (next.kind)
+        {
+            case POINT:
+                pieces.emplace_back((pz != nullptr) ?
+                                    new OGRPoint(*px, *py, *pz) :
+                                    new OGRPoint(*px, *py));
+                break;
+
+            case LINE:
+            {
+                auto line = std::make_unique<OGRLineString>();
+                line->setPoints(next.coord_count, px, py, pz);
+                pieces.push_back(std::move(line));
+                break;
+            }
+
+            case OUTER_RING:
+            case INNER_RING:
+            {
+                // Inner rings belong to the preceding polygon
+                if ((next.kind == OUTER_RING) || pieces.empty() ||
+                    (wkbFlatten(pieces.back()->getGeometryType()) != wkbPolygon))
+                {
+                    pieces.emplace_back(new OGRPolygon());
+                }
+                OGRLinearRing *ring = new OGRLinearRing();
+                ring->setPoints(next.coord_count, px, py, pz);
+                pieces.back()->toPolygon()->addRingDirectly(ring);
+                break;
+            }
+        }
+    }
+
+    // Reassemble as original geometry type
+    OGRwkbGeometryType type = wkbFlatten((OGRwkbGeometryType)feat.geom_type);
+    std::unique_ptr<OGRGeometryCollection> coll;
+    switch (type)
+    {
+        case wkbPoint:
+        case wkbLineString:
+        case wkbPolygon:
+            if (pieces.size() == 1)
+            {
+                return std::move(pieces.front());
+            }
+            coll = std::make_unique<OGRGeometryCollection>();
+            break;
+
+        case wkbMultiPoint:
+            coll = std::make_unique<OGRMultiPoint>();
+            break;
+
+        case wkbMultiLineString:
+            coll = std::make_unique<OGRMultiLineString>();
+            break;
+
+        case wkbMultiPolygon:
+            coll = std::make_unique<OGRMultiPolygon>();
+            break;
+
+        default:
+            coll = std::make_unique<OGRGeometryCollection>();
+            break;
+    }
+    for (auto &piece : pieces)
+    {
+        if (coll->addGeometryDirectly(piece.get()) == OGRERR_NONE)
+        {
+            piece.release();
+        }
+    }
+    return coll;
+}
+
+/**
+ * Open Chart Store
+ *
+ * \param[in] path Path to store file
+ * \return False if missing, invalid, or wrong version
+ */
+bool chart_store::open(const std::filesystem::path &path)
+{
+    layers_.clear();
+    if (!file_.open(path) || (file_.size() < sizeof(file_header)))
+    {
+        file_.close();
+        return false;
+    }
+
+    // Check header
+    const uint8_t *base = file_.data();
+    const uint64_t size = file_.size();
+    const file_header *head = reinterpret_cast<const file_header*>(base);
+    if ((memcmp(head->magic, file_magic, sizeof(file_magic)) != 0) ||
+        (head->version != version) ||
+        (sizeof(file_header) + (uint64_t)head->layer_count * sizeof(layer_header) > size))
+    {
+        file_.close();
+        return false;
+    }
+    file_size_ = head->file_size;
+    file_time_ = head->file_time;
+
+    // Section must be aligned, and within file
+    auto valid = [&](uint64_t offset, uint64_t bytes) {
+        return (offset % alignof(double) == 0) && (offset <= size) && (bytes <= size - offset);
+    };
+
+    // View each layer in place
+    const layer_header *lheads = reinterpret_cast<const layer_header*>(base + sizeof(file_header));
+    for (uint32_t i = 0; i < head->layer_count; i++)
+    {
+        const layer_header &lhead = lheads[i];
+        uint64_t coord_arrays = lhead.has_z ? 3 : 2;
+        if ((lhead.band >= band_count) ||
+            !valid(lhead.features_offset, (uint64_t)lhead.feature_count * sizeof(feature)) ||
+            !valid(lhead.parts_offset, (uint64_t)lhead.part_count * sizeof(part)) ||
+            !valid(lhead.coords_offset, coord_arrays * lhead.coord_count * sizeof(double)) ||
+            !valid(lhead.attrs_offset, (uint64_t)lhead.attr_count *
+                   (name_size + (uint64_t)lhead.feature_count * sizeof(double))))
+        {
+            layers_.clear();
+            file_.close();
+            return false;
+        }
+
+        layer next;
+        next.name = unpack_name(lhead.name);
+        next.band = lhead.band;
+        next.feature_count = lhead.feature_count;
+        next.features = reinterpret_cast<const feature*>(base + lhead.features_offset);
+        next.parts = reinterpret_cast<const part*>(base + lhead.parts_offset);
+        const double *coords = reinterpret_cast<const double*>(base + lhead.coords_offset);
+        next.x = coords;
+        next.y = coords + lhead.coord_count;
+        next.z = lhead.has_z ? coords + 2 * lhead.coord_count : nullptr;
+        const char *names = reinterpret_cast<const char*>(base + lhead.attrs_offset);
+        for (uint32_t j = 0; j < lhead.attr_count; j++)
+        {
+            next.attr_names.push_back(unpack_name(names + j * name_size));
+        }
+        next.attr_values = reinterpret_cast<const double*>(names + lhead.attr_count * name_size);
+
+        // Parts must stay within their layer
+        for (std::size_t j = 0; j < next.feature_count; j++)
+        {
+            const feature &feat = next.features[j];
+            if ((uint64_t)feat.part_first + feat.part_count > lhead.part_count)
+            {
+                layers_.clear();
+                file_.close();
+                return false;
+            }
+        }
+        for (uint32_t j = 0; j < lhead.part_count; j++)
+        {
+            const part &pt = next.parts[j];
+            if ((uint64_t)pt.coord_first + pt.coord_count > lhead.coord_count)
+            {
+                layers_.clear();
+                file_.close();
+                return false;
+            }
+        }
+
+        layers_.push_back(std::move(next));
+    }
+
+    return true;
+}
+
+/**
+ * Check Store Matches Chart
+ *
+ * \param[in] chart Chart metadata
+ * \return True if store was built from this version of chart
+ */
+bool chart_store::matches(const chart_metadata &chart) const
+{
+    return (file_.data() != nullptr) &&
+        (file_size_ == chart.file_size) &&
+        (file_time_ == chart.file_time);
+}
+
+/**
+ * Find Layer
+ *
+ * Picks the most generalized band suitable for the presentation scale,
+ * falling back to less generalized bands where one was not stored.
+ *
+ * \param[in] name Layer name (S57 object class)
+ * \param[in] scale_min Minimum presentation scale (0 = full resolution)
+ * \return Layer view, or nullptr if not present
+ */
+const chart_store::layer *chart_store::find_layer(const std::string &name,
+                                                  int scale_min) const
+{
+    const layer *best = nullptr;
+    for (const layer &next : layers_)
+    {
+        if ((next.name == name) && (band_scale(next.band) <= scale_min) &&
+            ((best == nullptr) || (next.band > best->band)))
+        {
+            best = &next;
+        }
+    }
+    return best;
+}
+
+/**
+ * Check Store File Is Current
+ *
+ * Only the file header is read.
+ *
+ * \param[in] path Path to store file
+ * \param[in] chart Chart metadata
+ * \return True if file has current version, and matches chart
+ */
+bool chart_store::is_current(const std::filesystem::path &path,
+                             const chart_metadata &chart)
+{
+    FILE *handle = fopen(path.c_str(), "rb");
+    if (handle == nullptr)
+    {
+        return false;
+    }
+    file_header head = {};
+    bool ok = (fread(&head, sizeof(head), 1, handle) == 1);
+    fclose(handle);
+
+    return ok &&
+        (memcmp(head.magic, file_magic, sizeof(file_magic)) == 0) &&
+        (head.version == version) &&
+        (head.file_size == chart.file_size) &&
+        (head.file_time == chart.file_time);
+}
+
+/**
+ * Write Chart Store
+ *
+ * Written to a temporary file, then atomically renamed into place.
+ *
+ * \param[in] path Path to store file
+ * \param[in] chart Chart metadata (for fingerprint)
+ * \param[in] ds Opened chart dataset
+ * \return False on failure
+ */
+bool chart_store::write(const std::filesystem::path &path,
+                        const chart_metadata &chart, GDALDataset *ds)
+{
+    // Read all layers with any geometry
+    std::vector<layer_data> layers;
+    for (int i = 0; i < ds->GetLayerCount(); i++)
+    {
+        layer_data data = read_layer(ds->GetLayer(i), 0);
+        if (data.features.empty())
+        {
+            continue;
+        }
+        if ((data.name.size() >= name_size) ||
+            (data.x.size() > std::numeric_limits<uint32_t>::max()))
+        {
+            return false;
+        }
+        for (const std::string &name : data.attr_names)
+        {
+            if (name.size() >= name_size)
+            {
+                return false;
+            }
+        }
+
+        // Point layers gain nothing from generalization
+        bool has_lines = std::any_of(data.parts.begin(), data.parts.end(),
+                                     [](const part &pt) { return pt.kind != POINT; });
+        std::size_t coord_count = data.x.size();
+        layers.push_back(std::move(data));
+
+        // Keep generalized bands only where they drop a useful share of
+        // coordinates, otherwise the previous band is used in their place
+        for (std::size_t band = 1; has_lines && (band < band_count); band++)
+        {
+            layer_data simple = read_layer(ds->GetLayer(i), band);
+            if (simple.x.size() * 4 <= coord_count * 3)
+            {
+                coord_count = simple.x.size();
+                layers.push_back(std::move(simple));
+            }
+        }
+    }
+
+    // Build headers and sections
+    file_header head = {};
+    memcpy(head.magic, file_magic, sizeof(file_magic));
+    head.version = version;
+    head.layer_count = layers.size();
+    head.file_size = chart.file_size;
+    head.file_time = chart.file_time;
+
+    std::vector<layer_header> lheads(layers.size());
+    std::string body;
+    uint64_t body_offset = sizeof(file_header) + lheads.size() * sizeof(layer_header);
+    for (std::size_t i = 0; i < layers.size(); i++)
+    {
+        const layer_data &data = layers[i];
+        layer_header &lhead = lheads[i];
+        pack_name(lhead.name, data.name);
+        lhead.feature_count = data.features.size();
+        lhead.part_count = data.parts.size();
+        lhead.coord_count = data.x.size();
+        lhead.attr_count = data.attr_names.size();
+        lhead.has_z = data.has_z;
+        lhead.band = data.band;
+
+        lhead.features_offset = body_offset + body.size();
+        append(body, data.features.data(), data.features.size());
+        lhead.parts_offset = body_offset + body.size();
+        append(body, data.parts.data(), data.parts.size());
+        lhead.coords_offset = body_offset + body.size();
+        append(body, data.x.data(), data.x.size());
+        append(body, data.y.data(), data.y.size());
+        append(body, data.z.data(), data.z.size());
+        lhead.attrs_offset = body_offset + body.size();
+        for (const std::string &name : data.attr_names)
+        {
+            char packed[name_size];
+            pack_name(packed, name);
+            append(body, packed, name_size);
+        }
+        for (const std::vector<double> &values : data.attr_values)
+        {
+            append(body, values.data(), values.size());
+        }
+    }
+
+    // Write to temporary file, then swap into place
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp." + std::to_string(getpid());
+    FILE *handle = fopen(temp_path.c_str(), "wb");
+    if (handle == nullptr)
+    {
+        return false;
+    }
+    bool ok =
+        (fwrite(&head, sizeof(head), 1, handle) == 1) &&
+        (fwrite(lheads.data(), sizeof(layer_header), lheads.size(), handle) == lheads.size()) &&
+        (fwrite(body.data(), 1, body.size(), handle) == body.size()) &&
+        (fflush(handle) == 0) &&
+        (fsync(fileno(handle)) == 0);
+    ok = (fclose(handle) == 0) && ok;
+
+    std::error_code ec;
+    if (ok)
+    {
+        std::filesystem::rename(temp_path, path, ec);
+        ok = !ec;
+    }
+    if (!ok)
+    {
+        std::filesystem::remove(temp_path, ec);
+    }
+    return ok;
+}
+
+}; // ~namespace encdata
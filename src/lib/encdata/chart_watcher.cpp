@@ -0,0 +1,196 @@
+/**
+ * \file
+ * \brief ENC Chart Watcher
+ *
+ * Watches an ENC_ROOT directory tree (via inotify) for added, changed, or
+ * removed files, reporting them in batches once changes settle.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <encdata/chart_watcher.h>
+#include <encdata/logger.h>
+
+namespace encdata
+{
+
+/// Events of interest (file writes finished, moves, deletes, and new directories)
+static const uint32_t watch_mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+    IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+/// File events that change charts (created files are only whole once closed)
+static const uint32_t file_mask = IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+/**
+ * Constructor
+ *
+ * \param[in] root Directory tree to watch
+ * \param[in] on_change Change callback
+ * \param[in] settle_ms Quiet time before reporting changes (ms)
+ */
+chart_watcher::chart_watcher(const std::filesystem::path &root, callback on_change,
+                             int settle_ms)
+    : root_(root), on_change_(on_change), settle_ms_(settle_ms)
+{
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0)
+    {
+        throw std::runtime_error("Cannot initialize inotify");
+    }
+    if (pipe2(stop_fd_, O_CLOEXEC) != 0)
+    {
+        close(inotify_fd_);
+        throw std::runtime_error("Cannot create watcher stop pipe");
+    }
+
+    add_watch(root_);
+    thread_ = std::thread(&chart_watcher::run, this);
+}
+
+/**
+ * Destructor
+ */
+chart_watcher::~chart_watcher()
+{
+    // Wake and stop watcher thread
+    char stop = 0;
+    if (write(stop_fd_[1], &stop, 1) != 1)
+    {
+        LOG_ERROR("Cannot stop chart watcher: %s", strerror(errno));
+    }
+    thread_.join();
+
+    close(stop_fd_[0]);
+    close(stop_fd_[1]);
+    close(inotify_fd_);
+}
+
+/**
+ * Watch Directory Tree
+ *
+ * \param[in] dir Directory to (recursively) watch
+ */
+void chart_watcher::add_watch(const std::filesystem::path &dir)
+{
+    // Inotify is not recursive, so each directory needs its own watch
+    int wd = inotify_add_watch(inotify_fd_, dir.c_str(), watch_mask);
+    if (wd < 0)
+    {
+        LOG_WARN("Cannot watch %s", dir.c_str());
+        return;
+    }
+    dirs_[wd] = dir;
+
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(dir, ec))
+    {
+        if (entry.is_directory(ec))
+        {
+            add_watch(entry.path());
+        }
+    }
+}
+
+/**
+ * Watcher Thread
+ */
+void chart_watcher::run()
+{
+    std::set<std::filesystem::path> pending;
+    alignas(inotify_event) char buffer[64 * 1024];
+
+    while (true)
+    {
+        // Wait for events, reporting pending changes once things go quiet
+        pollfd fds[2] = {
+            { inotify_fd_, POLLIN, 0 },
+            { stop_fd_[0], POLLIN, 0 },
+        };
+        int rc = poll(fds, 2, pending.empty() ? -1 : settle_ms_);
+        if ((rc < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+        if ((rc < 0) || (fds[1].revents != 0))
+        {
+            break;
+        }
+        if (rc == 0)
+        {
+            on_change_(pending);
+            pending.clear();
+            continue;
+        }
+
+        // Read available events
+        ssize_t len = read(inotify_fd_, buffer, sizeof(buffer));
+        if (len <= 0)
+        {
+            continue;
+        }
+        for (char *ptr = buffer; ptr < buffer + len; )
+        {
+            const inotify_event *event = reinterpret_cast<const inotify_event*>(ptr);
+            ptr += sizeof(inotify_event) + event->len;
+
+            // Lost events, so everything must be rescanned
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                on_change_({});
+                pending.clear();
+                continue;
+            }
+
+            auto it = dirs_.find(event->wd);
+            if (it == dirs_.end())
+            {
+                continue;
+            }
+            if (event->mask & IN_IGNORED)
+            {
+                dirs_.erase(it);
+                continue;
+            }
+            if (event->len == 0)
+            {
+                continue;
+            }
+
+            std::filesystem::path path = it->second / event->name;
+            if (!(event->mask & IN_ISDIR))
+            {
+                if (event->mask & file_mask)
+                {
+                    pending.insert(path);
+                }
+            }
+            else if (event->mask & (IN_CREATE | IN_MOVED_TO))
+            {
+                // New directory, whose contents may predate its watch
+                add_watch(path);
+                std::error_code ec;
+                for (const auto &entry :
+                         std::filesystem::recursive_directory_iterator(path, ec))
+                {
+                    if (entry.is_regular_file(ec))
+                    {
+                        pending.insert(entry.path());
+                    }
+                }
+            }
+            else if (event->mask & IN_MOVED_FROM)
+            {
+                // Directory moved away, so rescan for whatever was inside
+                on_change_({});
+                pending.clear();
+            }
+        }
+    }
+}
+
+}; // ~namespace encdata
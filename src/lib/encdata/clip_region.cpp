@@ -0,0 +1,143 @@
+/**
+ * \file
+ * \brief Clip Region
+ *
+ * Area that exported features are clipped to. Features disjoint from the
+ * area are rejected by bounding box, features fully within it are copied
+ * through, and only those crossing its boundary are intersected.
+ * Rectangular areas are clipped without GEOS.
+ */
+
+#include <encdata/clip_region.h>
+
+namespace encdata
+{
+
+/**
+ * Constructor
+ *
+ * \param[in] area Clipping area
+ */
+clip_region::clip_region(std::unique_ptr<OGRGeometry> area)
+    : area_(std::move(area))
+{
+    area_->getEnvelope(&bbox_);
+    if (OGRHasPreparedGeometrySupport())
+    {
+        prepared_.reset(OGRCreatePreparedGeometry(area_.get()));
+    }
+}
+
+/**
+ * Constructor
+ *
+ * \param[in] rect Rectangular clipping area
+ */
+clip_region::clip_region(const OGREnvelope &rect)
+    : bbox_(rect), rect_(rect)
+{
+}
+
+/**
+ * Get Clipping Area Bounding Box
+ *
+ * \return Bounding box (deg)
+ */
+const OGREnvelope &clip_region::bbox() const
+{
+    return bbox_;
+}
+
+/**
+ * Clip Geometry
+ *
+ * \param[in] geo Input geometry
+ * \return Clipped geometry, or nullptr if outside area
+ */
+std::unique_ptr<OGRGeometry> clip_region::clip(const OGRGeometry &geo) const
+{
+    switch (relate(geo))
+    {
+        case OUTSIDE:
+            return nullptr;
+        case INSIDE:
+            return std::unique_ptr<OGRGeometry>(geo.clone());
+        default:
+            return intersect(geo);
+    }
+}
+
+/**
+ * Clip Geometry
+ *
+ * \param[in] geo Input geometry (returned as is if within area)
+ * \return Clipped geometry, or nullptr if outside area
+ */
+std::unique_ptr<OGRGeometry> clip_region::clip(std::unique_ptr<OGRGeometry> geo) const
+{
+    switch (relate(*geo))
+    {
+        case OUTSIDE:
+            return nullptr;
+        case INSIDE:
+            return geo;
+        default:
+            return intersect(*geo);
+    }
+}
+
+/**
+ * Relate Geometry to Area
+ *
+ * \param[in] geo Input geometry
+ * \return Geometry relation
+ */
+clip_region::relation clip_region::relate(const OGRGeometry &geo) const
+{
+    // Cheapest rejection first
+    OGREnvelope env;
+    geo.getEnvelope(&env);
+    if (!bbox_.Intersects(env))
+    {
+        return OUTSIDE;
+    }
+
+    // Bounding box is exact for rectangles
+    if (rect_)
+    {
+        return bbox_.Contains(env) ? INSIDE : CROSSING;
+    }
+
+    // Prepared tests avoid building a new geometry where it's not needed
+    if (prepared_)
+    {
+        if (OGRPreparedGeometryContains(prepared_.get(), &geo))
+        {
+            return INSIDE;
+        }
+        if (!OGRPreparedGeometryIntersects(prepared_.get(), &geo))
+        {
+            return OUTSIDE;
+        }
+    }
+    return CROSSING;
+}
+
+/**
+ * Intersect Geometry with Area
+ *
+ * \param[in] geo Input geometry
+ * \return Intersection, or nullptr if empty
+ */
+std::unique_ptr<OGRGeometry> clip_region::intersect(const OGRGeometry &geo) const
+{
+    std::unique_ptr<OGRGeometry> out(rect_ ? rect_->clip(geo) :
+                                     std::unique_ptr<OGRGeometry>(geo.Intersection(area_.get())));
+    if (!out || out->IsEmpty())
+    {
+        return nullptr;
+    }
+    return out;
+}
+
+}; // ~namespace encdata
@@ -0,0 +1,204 @@
+/**
+ * \file
+ * \brief Coverage Mask
+ *
+ * Tracks which parts of an export area are covered by charts, as a bitmask
+ * of small cells rasterized from chart coverage polygons. Much cheaper than
+ * differencing polygons when only "is anything still missing?" matters.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <encdata/coverage_mask.h>
+
+namespace encdata
+{
+
+/**
+ * Constructor
+ *
+ * All cells start uncovered.
+ *
+ * \param[in] bbox Masked area (deg)
+ * \param[in] cols Cells across
+ * \param[in] rows Cells down
+ */
+coverage_mask::coverage_mask(const OGREnvelope &bbox, int cols, int rows)
+    : bbox_(bbox), cols_(std::max(cols, 1)), rows_(std::max(rows, 1)),
+      stride_((cols_ + 63) / 64), bits_((std::size_t)stride_ * rows_, 0),
+      remaining_((std::size_t)cols_ * rows_)
+{
+    // Padding past last column is never uncovered
+    if (cols_ % 64 != 0)
+    {
+        uint64_t padding = ~((1ULL << (cols_ % 64)) - 1);
+        for (int row = 0; row < rows_; row++)
+        {
+            bits_[(std::size_t)row * stride_ + stride_ - 1] |= padding;
+        }
+    }
+}
+
+/**
+ * Restrict to Area
+ *
+ * Marks cells outside area as covered, so only the area must be filled.
+ *
+ * \param[in] area Polygon, or collection of polygons
+ */
+void coverage_mask::restrict(const OGRGeometry &area)
+{
+    coverage_mask inside(bbox_, cols_, rows_);
+    inside.add(area);
+
+    remaining_ = 0;
+    for (std::size_t i = 0; i < bits_.size(); i++)
+    {
+        bits_[i] |= ~inside.bits_[i];
+        remaining_ += __builtin_popcountll(~bits_[i]);
+    }
+}
+
+/**
+ * Add Covered Area
+ *
+ * A cell is covered once its center is within a polygon.
+ *
+ * \param[in] area Polygon, or collection of polygons
+ * \return Number of cells newly covered
+ */
+std::size_t coverage_mask::add(const OGRGeometry &area)
+{
+    std::size_t added = 0;
+    if (wkbFlatten(area.getGeometryType()) == wkbPolygon)
+    {
+        added += add_polygon(*area.toPolygon());
+    }
+    else if (OGR_GT_IsSubClassOf(wkbFlatten(area.getGeometryType()), wkbGeometryCollection))
+    {
+        const OGRGeometryCollection *coll = area.toGeometryCollection();
+        for (int i = 0; (i < coll->getNumGeometries()) && (remaining_ > 0); i++)
+        {
+            added += add(*coll->getGeometryRef(i));
+        }
+    }
+    return added;
+}
+
+/**
+ * Check If Fully Covered
+ *
+ * \return True if no cells are left uncovered
+ */
+bool coverage_mask::full() const
+{
+    return remaining_ == 0;
+}
+
+/**
+ * Get Uncovered Cell Count
+ *
+ * \return Cells left uncovered
+ */
+std::size_t coverage_mask::remaining() const
+{
+    return remaining_;
+}
+
+/**
+ * Add Covered Polygon
+ *
+ * \param[in] poly Polygon (rings filled even-odd)
+ * \return Number of cells newly covered
+ */
+std::size_t coverage_mask::add_polygon(const OGRPolygon &poly)
+{
+    OGREnvelope extent;
+    poly.getEnvelope(&extent);
+    if (!extent.Intersects(bbox_))
+    {
+        return 0;
+    }
+
+    // Rows whose centers lie in [y0, y1)
+    double dx = (bbox_.MaxX - bbox_.MinX) / cols_;
+    double dy = (bbox_.MaxY - bbox_.MinY) / rows_;
+    auto row_of = [&](double y) {
+        return (int)std::clamp(std::ceil((y - bbox_.MinY) / dy - 0.5), 0.0, (double)rows_);
+    };
+    auto col_of = [&](double x) {
+        return (int)std::clamp(std::ceil((x - bbox_.MinX) / dx - 0.5), 0.0, (double)cols_);
+    };
+
+    // Collect ring crossings of each row center line covered by the polygon
+    int row_first = row_of(extent.MinY);
+    int row_last = row_of(extent.MaxY);
+    if (row_first >= row_last)
+    {
+        return 0;
+    }
+    std::vector<std::vector<double>> crossings(row_last - row_first);
+    for (int r = -1; r < poly.getNumInteriorRings(); r++)
+    {
+        const OGRLinearRing *ring = (r < 0) ? poly.getExteriorRing() : poly.getInteriorRing(r);
+        if (ring == nullptr)
+        {
+            continue;
+        }
+        for (int i = 0; i + 1 < ring->getNumPoints(); i++)
+        {
+            double x0 = ring->getX(i);
+            double y0 = ring->getY(i);
+            double x1 = ring->getX(i + 1);
+            double y1 = ring->getY(i + 1);
+            int first = row_of(std::min(y0, y1));
+            int last = row_of(std::max(y0, y1));
+            for (int row = first; row < last; row++)
+            {
+                double yc = bbox_.MinY + (row + 0.5) * dy;
+                crossings[row - row_first].push_back(x0 + (yc - y0) * (x1 - x0) / (y1 - y0));
+            }
+        }
+    }
+
+    // Fill between crossing pairs
+    std::size_t added = 0;
+    for (int row = row_first; row < row_last; row++)
+    {
+        std::vector<double> &xs = crossings[row - row_first];
+        std::sort(xs.begin(), xs.end());
+        for (std::size_t i = 0; i + 1 < xs.size(); i += 2)
+        {
+            added += fill(row, col_of(xs[i]), col_of(xs[i + 1]));
+        }
+    }
+    return added;
+}
+
+/**
+ * Cover Row Span
+ *
+ * \param[in] row Cell row
+ * \param[in] first First cell column
+ * \param[in] last One past last cell column
+ * \return Number of cells newly covered
+ */
+std::size_t coverage_mask::fill(int row, int first, int last)
+{
+    std::size_t added = 0;
+    uint64_t *line = &bits_[(std::size_t)row * stride_];
+    while (first < last)
+    {
+        int word = first / 64;
+        int bit = first % 64;
+        int count = std::min(64 - bit, last - first);
+        uint64_t mask = (count == 64) ? ~0ULL : (((1ULL << count) - 1) << bit);
+        added += __builtin_popcountll(mask & ~line[word]);
+        line[word] |= mask;
+        first += count;
+    }
+    remaining_ -= added;
+    return added;
+}
+
+}; // ~namespace encdata
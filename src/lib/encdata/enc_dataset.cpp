@@ -7,12 +7,22 @@
  * data for later handling.
  */
 
+#include <cctype>
+#include <cmath>
 #include <iostream>
-#include <fstream>
+#include <sstream>
 #include <algorithm>
 #include <filesystem>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <encdata/enc_dataset.h>
+#include <encdata/logger.h>
 
 // Helper macro for data presence
 #define CHECKNULL(ptr, msg) if ((ptr) == nullptr) throw std::runtime_error((msg))
@@ -20,10 +30,588 @@
 namespace encdata
 {
 
+/// Simplification tolerance for chart coverage polygons (deg)
+static constexpr double coverage_tolerance = 0.0005;
+
+/**
+ * Add Polygons to Area
+ *
+ * \param[out] area Output area
+ * \param[in] geo Polygon, or collection of polygons
+ */
+static void add_polygons(OGRMultiPolygon &area, const OGRGeometry *geo)
+{
+    if (wkbFlatten(geo->getGeometryType()) == wkbPolygon)
+    {
+        area.addGeometry(geo);
+    }
+    else if (OGR_GT_IsSubClassOf(wkbFlatten(geo->getGeometryType()), wkbGeometryCollection))
+    {
+        const OGRGeometryCollection *coll = geo->toGeometryCollection();
+        for (int i = 0; i < coll->getNumGeometries(); i++)
+        {
+            add_polygons(area, coll->getGeometryRef(i));
+        }
+    }
+}
+
+/**
+ * Grow Rectangle
+ *
+ * \param[in] rect Bounding box
+ * \param[in] margin Margin on each side, as a fraction of box size
+ * \return Grown bounding box
+ */
+static OGREnvelope grow_rect(const OGREnvelope &rect, double margin)
+{
+    double dx = margin * (rect.MaxX - rect.MinX);
+    double dy = margin * (rect.MaxY - rect.MinY);
+    OGREnvelope grown = rect;
+    grown.MinX -= dx;
+    grown.MaxX += dx;
+    grown.MinY -= dy;
+    grown.MaxY += dy;
+    return grown;
+}
+
+/// Destination for exported features
+class enc_dataset::export_sink
+{
+public:
+
+    /**
+     * Destructor
+     */
+    virtual ~export_sink() = default;
+
+    /**
+     * Add Output Layer
+     *
+     * \param[in] name Layer name
+     */
+    virtual void add_layer(const std::string &name) = 0;
+
+    /**
+     * Get Output Field
+     *
+     * \param[in] layer Output layer index
+     * \param[in] defn Field definition
+     * \return Index of field, created if missing (-1 if not kept)
+     */
+    virtual int get_field(std::size_t layer, const OGRFieldDefn &defn) = 0;
+
+    /**
+     * Check If Chart Stores May Be Used
+     *
+     * Chart stores keep only numeric attributes, and geometry generalized
+     * for the scale, so only sinks needing no more may read from them.
+     *
+     * \return True if features may come from chart stores
+     */
+    virtual bool use_stores() const = 0;
+
+    /**
+     * Add Feature Without Attributes
+     *
+     * \param[in] layer Output layer index
+     * \param[in] geo Clipped geometry
+     * \param[in] outline Draw polygon outlines (false for pieces of a split polygon)
+     */
+    virtual void add_feature(std::size_t layer, std::unique_ptr<OGRGeometry> geo,
+                             bool outline) = 0;
+
+    /**
+     * Add Feature From OGR Feature
+     *
+     * \param[in] layer Output layer index
+     * \param[in] geo Clipped geometry
+     * \param[in] src Source feature
+     * \param[in] fields Output field of each source field (-1 to skip)
+     */
+    virtual void add_feature(std::size_t layer, std::unique_ptr<OGRGeometry> geo,
+                             const OGRFeature &src, const std::vector<int> &fields) = 0;
+
+    /**
+     * Add Feature From Chart Store
+     *
+     * \param[in] layer Output layer index
+     * \param[in] geo Clipped geometry
+     * \param[in] src Source chart store layer
+     * \param[in] idx Source feature index
+     * \param[in] fields Output field of each source attribute (-1 to skip)
+     */
+    virtual void add_feature(std::size_t layer, std::unique_ptr<OGRGeometry> geo,
+                             const chart_store::layer &src, std::size_t idx,
+                             const std::vector<int> &fields) = 0;
+};
+
+/// Exports features to GDAL dataset layers
+class enc_dataset::dataset_sink : public enc_dataset::export_sink
+{
+public:
+
+    /**
+     * Constructor
+     *
+     * \param[out] ds Output dataset
+     */
+    dataset_sink(GDALDataset *ds)
+        : ds_(ds)
+    {
+    }
+
+    void add_layer(const std::string &name) override
+    {
+        OGRLayer *layer = ds_->CreateLayer(name.c_str(), nullptr, wkbUnknown, nullptr);
+        CHECKNULL(layer, "Cannot create output layer");
+        layers_.push_back(layer);
+    }
+
+    int get_field(std::size_t layer, const OGRFieldDefn &defn) override
+    {
+        OGRLayer *olayer = layers_[layer];
+        int idx = olayer->GetLayerDefn()->GetFieldIndex(defn.GetNameRef());
+        if (idx < 0)
+        {
+            OGRFieldDefn copy(&defn);
+            if (olayer->CreateField(&copy) != OGRERR_NONE)
+            {
+                throw std::runtime_error("Cannot create layer field");
+            }
+            idx = olayer->GetLayerDefn()->GetFieldCount() - 1;
+        }
+        return idx;
+    }
+
+    bool use_stores() const override
+    {
+        // Exports keep all attributes, at full resolution
+        return false;
+    }
+
+    void add_feature(std::size_t layer, std::unique_ptr<OGRGeometry> geo,
+                     bool outline) override
+    {
+        OGRFeature ofeat(layers_[layer]->GetLayerDefn());
+        ofeat.SetGeometryDirectly(geo.release());
+        create_feature(layer, ofeat);
+    }
+
+    void add_feature(std::size_t layer, std::unique_ptr<OGRGeometry> geo,
+                     const OGRFeature &src, const std::vector<int> &fields) override
+    {
+        OGRFeature ofeat(layers_[layer]->GetLayerDefn());
+        ofeat.SetFieldsFrom(&src, fields.data());
+        ofeat.SetGeometryDirectly(geo.release());
+        create_feature(layer, ofeat);
+    }
+
+    void add_feature(std::size_t layer, std::unique_ptr<OGRGeometry> geo,
+                     const chart_store::layer &src, std::size_t idx,
+                     const std::vector<int> &fields) override
+    {
+        throw std::runtime_error("Chart store features not supported in dataset export");
+    }
+
+private:
+
+    /**
+     * Write Output Feature
+     *
+     * \param[in] layer Output layer index
+     * \param[in] feat Output feature
+     */
+    void create_feature(std::size_t layer, OGRFeature &feat)
+    {
+        if (layers_[layer]->CreateFeature(&feat) != OGRERR_NONE)
+        {
+            throw std::runtime_error("Cannot create layer feature");
+        }
+    }
+
+    /// Output dataset
+    GDALDataset *ds_;
+
+    /// Output layers
+    std::vector<OGRLayer*> layers_;
+};
+
+/// Exports features to a feature set, keeping only numeric attributes
+class enc_dataset::feature_sink : public enc_dataset::export_sink
+{
+public:
+
+    /**
+     * Constructor
+     *
+     * \param[out] out Output feature set (cleared)
+     */
+    feature_sink(feature_set &out)
+        : out_(out)
+    {
+        out_.clear();
+    }
+
+    void add_layer(const std::string &name) override
+    {
+        out_.add_layer(name);
+    }
+
+    int get_field(std::size_t layer, const OGRFieldDefn &defn) override
+    {
+        switch (defn.GetType())
+        {
+            case OFTInteger:
+            case OFTInteger64:
+            case OFTReal:
+                return out_[layer].add_attr(defn.GetNameRef());
+
+            default:
+                return -1;
+        }
+    }
+
+    bool use_stores() const override
+    {
+        // Only numeric attributes are kept, for the scale rendered
+        return true;
+    }
+
+    void add_feature(std::size_t layer, std::unique_ptr<OGRGeometry> geo,
+                     bool outline) override
+    {
+        out_[layer].add_feature(*geo, outline);
+    }
+
+    void add_feature(std::size_t layer, std::unique_ptr<OGRGeometry> geo,
+                     const OGRFeature &src, const std::vector<int> &fields) override
+    {
+        feature_set::layer &olayer = out_[layer];
+        std::size_t idx = olayer.add_feature(*geo);
+        for (std::size_t i = 0; i < fields.size(); i++)
+        {
+            if ((fields[i] >= 0) && src.IsFieldSetAndNotNull(i))
+            {
+                olayer.set_attr(idx, fields[i], src.GetFieldAsDouble(i));
+            }
+        }
+    }
+
+    void add_feature(std::size_t layer, std::unique_ptr<OGRGeometry> geo,
+                     const chart_store::layer &src, std::size_t idx,
+                     const std::vector<int> &fields) override
+    {
+        feature_set::layer &olayer = out_[layer];
+        std::size_t oidx = olayer.add_feature(*geo);
+        for (std::size_t i = 0; i < fields.size(); i++)
+        {
+            if (fields[i] >= 0)
+            {
+                olayer.set_attr(oidx, fields[i], src.attr(i, idx));
+            }
+        }
+    }
+
+private:
+
+    /// Output feature set
+    feature_set &out_;
+};
+
+/// Buffers exported features, to be replayed into another sink later
+class enc_dataset::buffer_sink : public enc_dataset::export_sink
+{
+public:
+
+    void add_layer(const std::string &name) override
+    {
+        // Layers are only created in the final sink
+    }
+
+    int get_field(std::size_t layer, const OGRFieldDefn &defn) override
+    {
+        fields_.push_back({ layer, std::make_unique<OGRFieldDefn>(&defn) });
+        return fields_.size() - 1;
+    }
+
+    bool use_stores() const override
+    {
+        // Checked against the sink replayed into
+        return true;
+    }
+
+    void add_feature(std::size_t layer, std::unique_ptr<OGRGeometry> geo,
+                     bool outline) override
+    {
+        entries_.push_back({ layer, std::move(geo), nullptr, nullptr, 0, 0, outline });
+    }
+
+    void add_feature(std::size_t layer, std::unique_ptr<OGRGeometry> geo,
+                     const OGRFeature &src, const std::vector<int> &fields) override
+    {
+        entries_.push_back({ layer, std::move(geo), std::unique_ptr<OGRFeature>(src.Clone()),
+                             nullptr, 0, get_map(fields), true });
+    }
+
+    void add_feature(std::size_t layer, std::unique_ptr<OGRGeometry> geo,
+                     const chart_store::layer &src, std::size_t idx,
+                     const std::vector<int> &fields) override
+    {
+        entries_.push_back({ layer, std::move(geo), nullptr, &src, idx, get_map(fields),
+                             true });
+    }
+
+    /**
+     * Replay Buffered Features
+     *
+     * Features are added in the order buffered, and then cleared.
+     *
+     * \param[out] out Output features (with layers already added)
+     */
+    void replay(export_sink &out)
+    {
+        // Map buffered fields to output fields
+        std::vector<int> remap(fields_.size());
+        for (std::size_t i = 0; i < fields_.size(); i++)
+        {
+            remap[i] = out.get_field(fields_[i].layer, *fields_[i].defn);
+        }
+        for (std::vector<int> &next : maps_)
+        {
+            for (int &field : next)
+            {
+                field = (field >= 0) ? remap[field] : -1;
+            }
+        }
+
+        for (entry &next : entries_)
+        {
+            if (next.feat)
+            {
+                out.add_feature(next.layer, std::move(next.geo), *next.feat, maps_[next.map]);
+            }
+            else if (next.slayer != nullptr)
+            {
+                out.add_feature(next.layer, std::move(next.geo), *next.slayer, next.idx,
+                                maps_[next.map]);
+            }
+            else
+            {
+                out.add_feature(next.layer, std::move(next.geo), next.outline);
+            }
+        }
+
+        fields_.clear();
+        maps_.clear();
+        entries_.clear();
+    }
+
+private:
+
+    /// Buffered field definition
+    struct field
+    {
+        /// Output layer index
+        std::size_t layer;
+
+        /// Field definition
+        std::unique_ptr<OGRFieldDefn> defn;
+    };
+
+    /// Buffered feature
+    struct entry
+    {
+        /// Output layer index
+        std::size_t layer;
+
+        /// Clipped geometry
+        std::unique_ptr<OGRGeometry> geo;
+
+        /// Source feature (if from OGR layer)
+        std::unique_ptr<OGRFeature> feat;
+
+        /// Source chart store layer (if from chart store)
+        const chart_store::layer *slayer;
+
+        /// Source chart store feature index
+        std::size_t idx;
+
+        /// Field map index
+        std::size_t map;
+
+        /// Draw polygon outlines (features without attributes)
+        bool outline;
+    };
+
+    /**
+     * Get Field Map
+     *
+     * Consecutive features of a layer share one field map.
+     *
+     * \param[in] fields Buffered field of each source field (-1 to skip)
+     * \return Field map index
+     */
+    std::size_t get_map(const std::vector<int> &fields)
+    {
+        if (maps_.empty() || (maps_.back() != fields))
+        {
+            maps_.push_back(fields);
+        }
+        return maps_.size() - 1;
+    }
+
+    /// Buffered field definitions
+    std::vector<field> fields_;
+
+    /// Field maps (buffered field of each source field)
+    std::vector<std::vector<int>> maps_;
+
+    /// Buffered features
+    std::vector<entry> entries_;
+};
+
+/// Chart planned for export
+struct chart_job
+{
+    /// Chart store (null if using chart dataset)
+    const chart_store *store = nullptr;
+
+    /// Leased chart dataset (without chart store)
+    std::optional<chart_cache::handle> lease;
+
+    /// Area this chart fills, by layer clip bounds
+    std::vector<clip_region> regions;
+
+    /// Per layer statistics (empty if not collecting)
+    std::vector<export_stats::layer_stats> lstats;
+};
+
+/// Adds time spent in scope to an export stage (if collecting stats)
+class stage_timer
+{
+public:
+
+    /**
+     * Constructor
+     *
+     * \param[out] stats Export statistics (nullptr to skip)
+     * \param[in] stage Timed stage
+     */
+    stage_timer(export_stats *stats, export_stats::stage stage)
+        : stats_(stats), stage_(stage)
+    {
+        if (stats_ != nullptr)
+        {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    /**
+     * Destructor
+     */
+    ~stage_timer()
+    {
+        stop();
+    }
+
+    /**
+     * Stop Timing
+     */
+    void stop()
+    {
+        if (stats_ != nullptr)
+        {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            stats_->stage_ns[stage_] +=
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            stats_ = nullptr;
+        }
+    }
+
+private:
+
+    /// Export statistics (nullptr once stopped)
+    export_stats *stats_;
+
+    /// Timed stage
+    export_stats::stage stage_;
+
+    /// Start time
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * Get Layer Statistics
+ *
+ * \param[in] stats Export statistics (may be nullptr)
+ * \param[in] idx Output layer index
+ * \return Layer statistics, or nullptr if not collecting
+ */
+static export_stats::layer_stats *get_layer_stats(export_stats *stats, std::size_t idx)
+{
+    return (stats != nullptr) ? &stats->layers[idx] : nullptr;
+}
+
+/**
+ * Check for S57 Data File
+ *
+ * \param[in] path File path
+ * \return True for base cells (.000) and updates (.001 to .999)
+ */
+static bool is_s57_file(const std::filesystem::path &path)
+{
+    std::string ext = path.extension().string();
+    return (ext.size() == 4) &&
+        std::all_of(ext.begin() + 1, ext.end(), [](char c) { return isdigit((unsigned char)c); });
+}
+
+/**
+ * Add File to Chart Fingerprint
+ *
+ * \param[out] meta Chart metadata
+ * \param[in] entry Chart or update file
+ */
+static void add_fingerprint(chart_metadata &meta,
+                            const std::filesystem::directory_entry &entry)
+{
+    std::error_code ec;
+    uintmax_t size = entry.file_size(ec);
+    if (!ec)
+    {
+        meta.file_size += size;
+    }
+    auto time = entry.last_write_time(ec);
+    if (!ec)
+    {
+        int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            time.time_since_epoch()).count();
+        meta.file_time = std::max(meta.file_time, ns);
+    }
+}
+
+/**
+ * Fingerprint Chart and Updates
+ *
+ * \param[in,out] meta Chart metadata (with path set)
+ */
+static void add_fingerprints(chart_metadata &meta)
+{
+    std::error_code ec;
+    for (const auto &entry :
+             std::filesystem::directory_iterator(meta.path.parent_path(), ec))
+    {
+        if (is_s57_file(entry.path()) && (entry.path().stem() == meta.path.stem()))
+        {
+            add_fingerprint(meta, entry);
+        }
+    }
+}
+
 /**
  * Constructor
  */
 enc_dataset::enc_dataset()
+    : index_threads_(0), clip_threads_(1), coverage_cells_(0), use_store_(false)
 {
     // Cache location
     char *phome = getenv("HOME");
@@ -33,9 +621,17 @@ enc_dataset::enc_dataset()
         cache_ += "/.enctools/meta";
     }
 
-    // Get GDAL driver
-    mem_drv_ = GetGDALDriverManager()->GetDriverByName(GDAL_MEM_DRIVER);
-    CHECKNULL(mem_drv_, "Cannot load OGR memory driver");
+    // Start with no charts
+    publish({});
+}
+
+/**
+ * Destructor
+ */
+enc_dataset::~enc_dataset()
+{
+    // Stop watcher before anything it may update goes away
+    watcher_.reset();
 }
 
 /**
@@ -48,6 +644,77 @@ void enc_dataset::set_cache_path(const std::filesystem::path &cache_path)
     cache_ = cache_path;
 }
 
+/**
+ * Set Chart Indexing Threads
+ *
+ * \param[in] threads Worker thread count (0 = hardware concurrency)
+ */
+void enc_dataset::set_index_threads(unsigned int threads)
+{
+    index_threads_ = threads;
+}
+
+/**
+ * Set Chart Dataset Cache Budget
+ *
+ * \param[in] bytes Size budget for idle opened charts (bytes)
+ */
+void enc_dataset::set_chart_cache(std::size_t bytes)
+{
+    datasets_.set_budget(bytes);
+}
+
+/**
+ * Get Chart Dataset Cache Counters
+ *
+ * \return Current counters
+ */
+chart_cache::stats enc_dataset::get_cache_stats() const
+{
+    return datasets_.get_stats();
+}
+
+/**
+ * Set Export Clipping Threads
+ *
+ * Charts used by a single export are clipped in parallel by this many
+ * threads, with features merged back in chart order.
+ *
+ * \param[in] threads Worker thread count (1 = sequential, 0 = hardware concurrency)
+ */
+void enc_dataset::set_clip_threads(unsigned int threads)
+{
+    clip_threads_ = threads;
+}
+
+/**
+ * Set Coverage Mask Resolution
+ *
+ * When set, exports track remaining uncovered area with a bitmask of this
+ * many cells across (and down), rather than checking the polygon residue
+ * after every chart.
+ *
+ * \param[in] cells Mask cells across export area (0 = polygon residue only)
+ */
+void enc_dataset::set_coverage_mask(int cells)
+{
+    coverage_cells_ = cells;
+}
+
+/**
+ * Enable Preprocessed Chart Store
+ *
+ * When enabled, a compact chart store is built for each chart alongside
+ * its cached metadata, and used for feature set export instead of the S57
+ * chart. Dataset export always reads the S57 chart.
+ *
+ * \param[in] enable Build and use chart stores
+ */
+void enc_dataset::set_chart_store(bool enable)
+{
+    use_store_ = enable;
+}
+
 /**
  * Set Default Land Coverage
  *
@@ -57,328 +724,908 @@ void enc_dataset::set_cache_path(const std::filesystem::path &cache_path)
 void enc_dataset::set_default_land(const std::string &file_name,
                                    const std::string &layer_name)
 {
-    land_file_name_ = file_name;
-    land_layer_name_ = layer_name;
+    // Load default land layer into memory, once
+    if (!land_.load(file_name, layer_name))
+    {
+        LOG_WARN("Default land disabled, cannot open: %s", file_name.c_str());
+    }
+    else
+    {
+        LOG_INFO("Default land loaded: %s [%s]", file_name.c_str(),
+                 layer_name.empty() ? "first layer" : layer_name.c_str());
+    }
+}
+
+/**
+ * Clear Chart Index
+ */
+void enc_dataset::clear()
+{
+    std::lock_guard<std::mutex> lock(update_mutex_);
+    publish({});
+}
+
+/**
+ * Recursively Load ENC Charts
+ *
+ * Replaces any previously loaded charts. Only new charts, or charts
+ * whose files changed since last indexed, are parsed.
+ *
+ * \param[in] enc_root ENC_ROOT base directory
+ */
+void enc_dataset::load_charts(const std::string &enc_root)
+{
+    std::lock_guard<std::mutex> lock(update_mutex_);
+
+    // Collect chart paths, with size and time fingerprints covering both
+    // base cells (.000) and their updates (.001, ...), in a fixed order so
+    // merging is deterministic
+    std::map<std::filesystem::path, metadata> found;
+    auto rdi = std::filesystem::recursive_directory_iterator(enc_root);
+    for (const std::filesystem::directory_entry &entry : rdi)
+    {
+        if (is_s57_file(entry.path()))
+        {
+            const std::filesystem::path &path = entry.path();
+            metadata &next = found[path.parent_path() / path.stem()];
+            add_fingerprint(next, entry);
+            if (path.extension() == ".000")
+            {
+                next.path = path;
+            }
+        }
+    }
+    std::vector<metadata> results;
+    for (auto &[key, next] : found)
+    {
+        if (!next.path.empty())
+        {
+            results.push_back(std::move(next));
+        }
+    }
+
+    // Map existing chart metadata, if any
+    std::error_code ec;
+    std::filesystem::create_directories(cache_, ec);
+    meta_file_.open(cache_ / "charts.idx");
+
+    // Worker state
+    std::vector<char> loaded(results.size(), 0);
+    std::atomic<std::size_t> next_path{0};
+    std::atomic<std::size_t> done{0};
+    std::atomic<std::size_t> failed{0};
+    std::atomic<std::size_t> parsed{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+
+    // Each worker opens its own GDAL handles, and writes only its own results
+    auto worker = [&]() {
+        std::size_t i;
+        while ((i = next_path++) < results.size())
+        {
+            try
+            {
+                bool from_disk = false;
+                loaded[i] = index_chart(results[i], from_disk);
+                parsed += from_disk;
+            }
+            catch (const std::exception &e)
+            {
+                // Skip bad charts, but keep going
+                LOG_WARN("Cannot index %s: %s", results[i].path.c_str(), e.what());
+            }
+            if (!loaded[i])
+            {
+                failed++;
+            }
+            if (++done == results.size())
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        }
+    };
+
+    // Start workers
+    unsigned int thread_count = index_threads_;
+    if (thread_count == 0)
+    {
+        thread_count = std::max(1U, std::thread::hardware_concurrency());
+    }
+    thread_count = std::min<std::size_t>(thread_count, std::max<std::size_t>(1, results.size()));
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < thread_count; i++)
+    {
+        threads.emplace_back(worker);
+    }
+
+    // Report progress until all charts are done
+    auto report = [&]() {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::size_t count = done;
+        LOG_INFO("Indexed %lu/%lu charts (%.1f charts/s)", count, results.size(),
+                 (elapsed.count() > 0) ? (count / elapsed.count()) : 0.0);
+    };
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!finished.wait_for(lock, std::chrono::seconds(1),
+                                  [&]() { return done == results.size(); }))
+        {
+            report();
+        }
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    report();
+
+    // Merge in path order, replacing any previous charts so that deleted
+    // charts are dropped
+    std::map<std::string, metadata> charts;
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        if (loaded[i])
+        {
+            charts[results[i].path.stem().string()] = std::move(results[i]);
+        }
+    }
+    auto current = publish(std::move(charts));
+
+    // Rewrite metadata file if chart set changed (new, updated, or deleted),
+    // or chart stores were found missing
+    bool lost_stores = use_store_ &&
+        std::any_of(current->charts.begin(), current->charts.end(), [](const auto &it) {
+            return it.second.store_version != chart_store::version; });
+    if ((parsed != 0) || (current->charts.size() != meta_file_.size()) || lost_stores)
+    {
+        save_metadata(*current);
+    }
+
+    LOG_INFO("%lu charts loaded (%lu parsed, %lu failed, %u threads)",
+             current->charts.size(), parsed.load(), failed.load(), thread_count);
+}
+
+/**
+ * Load Single ENC Chart
+ *
+ * \param[in] path Path to ENC chart
+ */
+bool enc_dataset::load_chart(const std::filesystem::path &path)
+{
+    std::lock_guard<std::mutex> lock(update_mutex_);
+
+    metadata next;
+    next.path = path;
+    add_fingerprints(next);
+
+    bool parsed = false;
+    if (!index_chart(next, parsed))
+    {
+        return false;
+    }
+
+    std::map<std::string, metadata> charts = get_charts()->charts;
+    charts[path.stem().string()] = next;
+    auto current = publish(std::move(charts));
+    if (parsed)
+    {
+        save_metadata(*current);
+    }
+    return true;
+}
+
+/**
+ * Watch for ENC Chart Changes
+ *
+ * Watches ENC_ROOT for new, updated, or removed charts, and re-indexes
+ * just those charts as they change. Updated chart sets are published
+ * atomically, so in-flight requests continue with the previous set.
+ *
+ * \param[in] enc_root ENC_ROOT base directory
+ */
+void enc_dataset::watch_charts(const std::string &enc_root)
+{
+    watcher_.reset();
+    watcher_ = std::make_unique<chart_watcher>(
+        enc_root, [this, enc_root](const std::set<std::filesystem::path> &files) {
+            try
+            {
+                if (files.empty())
+                {
+                    load_charts(enc_root);
+                }
+                else
+                {
+                    update_charts(files);
+                }
+            }
+            catch (const std::exception &e)
+            {
+                LOG_ERROR("Chart update failed: %s", e.what());
+            }
+        });
+    LOG_INFO("Watching for chart updates: %s", enc_root.c_str());
+}
+
+/**
+ * Export ENC Data to Empty Dataset
+ *
+ * Creates specified layers in output dataset, populating with best data
+ * available for given bounding box and minimum presentation scale.
+ *
+ * \param[out] ds Output dataset
+ * \param[in] layers Specified ENC layers (S57)
+ * \param[in] bbox Data bounding box (deg)
+ * \param[in] scale_min Minimum data compilation scale
+ * \param[out] stats Export statistics (nullptr to skip)
+ * \return False if no data available
+ */
+bool enc_dataset::export_data(GDALDataset *ods, const std::vector<std::string> &layers,
+                              const OGREnvelope &bbox, int scale_min, export_stats *stats)
+{
+    dataset_sink sink(ods);
+    return export_region(sink, all_fields(layers), rect_to_polygon(bbox), &bbox, scale_min,
+                         stats);
+}
+
+/**
+ * Export ENC Data to Empty Dataset
+ *
+ * Creates specified layers in output dataset, populating with best data
+ * available for given bounding box and minimum presentation scale.
+ *
+ * \param[out] ds Output dataset
+ * \param[in] layers Specified ENC layers (S57)
+ * \param[in] poly Data bounds (deg)
+ * \param[in] scale_min Minimum data compilation scale
+ * \param[out] stats Export statistics (nullptr to skip)
+ * \return False if no data available
+ */
+bool enc_dataset::export_data(GDALDataset *ods, const std::vector<std::string> &layers,
+                              const OGRPolygon &poly, int scale_min, export_stats *stats)
+{
+    dataset_sink sink(ods);
+    return export_region(sink, all_fields(layers), poly, nullptr, scale_min, stats);
+}
+
+/**
+ * Export ENC Data to Feature Set
+ *
+ * Replaces feature set contents with specified layers, populating with best
+ * data available for given bounding box and minimum presentation scale.
+ * Only numeric attributes are kept, and only those requested per layer.
+ * Each layer is clipped to the bounding box grown by its margin.
+ *
+ * \param[out] out Output feature set
+ * \param[in] layers Specified ENC layers (S57), and their attributes
+ * \param[in] bbox Data bounding box (deg)
+ * \param[in] scale_min Minimum data compilation scale
+ * \param[out] stats Export statistics (nullptr to skip)
+ * \return False if no data available
+ */
+bool enc_dataset::export_data(feature_set &out, const std::vector<layer_spec> &layers,
+                              const OGREnvelope &bbox, int scale_min, export_stats *stats)
+{
+    feature_sink sink(out);
+    return export_region(sink, layers, rect_to_polygon(bbox), &bbox, scale_min, stats);
+}
+
+/**
+ * Export ENC Data for Region
+ *
+ * \param[out] sink Output features
+ * \param[in] layers Specified ENC layers (S57), and their attributes
+ * \param[in] poly Data bounds (deg)
+ * \param[in] rect Data bounds, if poly is a rectangle (grown by layer margins, deg)
+ * \param[in] scale_min Minimum data compilation scale
+ * \param[out] stats Export statistics (nullptr to skip)
+ * \return False if no data available
+ */
+bool enc_dataset::export_region(export_sink &sink, const std::vector<layer_spec> &layers,
+                                const OGRPolygon &poly, const OGREnvelope *rect,
+                                int scale_min, export_stats *stats)
+{
+    // Start statistics for this export
+    if (stats != nullptr)
+    {
+        stats->clear();
+        stats->exports = 1;
+        for (const layer_spec &spec : layers)
+        {
+            stats->layers.push_back({ spec.name });
+        }
+    }
+    stage_timer select_timer(stats, export_stats::SELECT);
+
+    // Rectangular bounds grow by each layer's margin, with charts selected
+    // and coverage tracked over the largest. Layers sharing a margin share
+    // clip bounds.
+    std::vector<OGREnvelope> bounds;
+    std::vector<std::size_t> layer_bounds;
+    OGRPolygon grown;
+    const OGRPolygon *area = &poly;
+    OGREnvelope bbox;
+    poly.getEnvelope(&bbox);
+    for (const layer_spec &spec : layers)
+    {
+        OGREnvelope next = (rect != nullptr) ? grow_rect(*rect, spec.margin) : bbox;
+        auto it = std::find_if(bounds.begin(), bounds.end(), [&](const OGREnvelope &b) {
+            return b.Contains(next) && next.Contains(b); });
+        layer_bounds.push_back(it - bounds.begin());
+        if (it == bounds.end())
+        {
+            bounds.push_back(next);
+        }
+    }
+    if (rect != nullptr)
+    {
+        for (const OGREnvelope &next : bounds)
+        {
+            bbox.Merge(next);
+        }
+        grown = rect_to_polygon(bbox);
+        area = &grown;
+    }
+
+    LOG_DEBUG("Filter: Scale=%d, BBOX=(%g to %g),(%g to %g)",
+              scale_min, bbox.MinX, bbox.MaxX, bbox.MinY, bbox.MaxY);
+
+    // Query suitable charts, in ascending scale order (most detailed first),
+    // reusing result storage between queries on this thread. The chart set
+    // snapshot stays valid for this request, even if charts are updated.
+    std::shared_ptr<const chart_set> charts = get_charts();
+    thread_local std::vector<std::size_t> selected;
+    charts->index.query(selected, bbox, scale_min);
+    if (stats != nullptr)
+    {
+        stats->charts_considered = selected.size();
+    }
+
+    // Drop charts where no individual coverage polygon is within bounds,
+    // then any whose actual coverage polygon misses the area
+    OGRPreparedGeometryUniquePtr prepared;
+    if (OGRHasPreparedGeometrySupport())
+    {
+        prepared.reset(OGRCreatePreparedGeometry(area));
+    }
+    auto outside = [&](std::size_t idx) {
+        const std::vector<OGREnvelope> &coverage = charts->ordered[idx]->coverage;
+        if (!coverage.empty() &&
+            std::none_of(coverage.begin(), coverage.end(),
+                         [&](const OGREnvelope &part) { return bbox.Intersects(part); }))
+        {
+            return true;
+        }
+        const OGRGeometry *area = charts->areas[idx].get();
+        return prepared && (area != nullptr) &&
+            !OGRPreparedGeometryIntersects(prepared.get(), area);
+    };
+    selected.erase(std::remove_if(selected.begin(), selected.end(), outside),
+                   selected.end());
+    select_timer.stop();
+    if (stats != nullptr)
+    {
+        stats->charts_selected = selected.size();
+    }
+    if (selected.empty() && land_.empty())
+    {
+        return false;
+    }
+
+    // Dump what we have to log
+    LOG_DEBUG("Selected %lu/%lu charts", selected.size(), charts->charts.size());
+    if (logger::get().enabled(log_level::DEBUG))
+    {
+        for (std::size_t idx : selected)
+        {
+            const metadata *chart = charts->ordered[idx];
+            LOG_DEBUG(" - (%d) %s", chart->scale, chart->path.c_str());
+        }
+    }
+
+    // Create output layers
+    for (const layer_spec &spec : layers)
+    {
+        sink.add_layer(spec.name);
+    }
+
+    // Track area still missing coverage. Until any coverage is removed, a
+    // rectangular area is clipped directly, leaving GEOS for what remains.
+    std::unique_ptr<OGRGeometry> residue(area->clone());
+    bool rect_area = (rect != nullptr);
+    auto get_region = [&](std::size_t idx) {
+        if (rect_area)
+        {
+            return clip_region(bounds[idx]);
+        }
+        if (bounds[idx].Contains(bbox))
+        {
+            return clip_region(std::unique_ptr<OGRGeometry>(residue->clone()));
+        }
+        OGRPolygon limit = rect_to_polygon(bounds[idx]);
+        std::unique_ptr<OGRGeometry> part(residue->Intersection(&limit));
+        CHECKNULL(part, "Cannot limit area to layer bounds");
+        return clip_region(std::move(part));
+    };
+
+    // Remove coverage of used charts from area still missing coverage.
+    // Done only once the remaining area is needed, as the last chart used
+    // never needs it (unless default land fills in the rest).
+    std::vector<OGRMultiPolygon> pending;
+    auto remove_coverage = [&]() {
+        for (const OGRMultiPolygon &coverage : pending)
+        {
+            for (int i = 0; !residue->IsEmpty() && (i < coverage.getNumGeometries()); i++)
+            {
+                std::unique_ptr<OGRGeometry> next(residue->Difference(coverage.getGeometryRef(i)));
+                CHECKNULL(next, "Cannot remove chart coverage");
+                residue = std::move(next);
+            }
+            rect_area = rect_area && coverage.IsEmpty();
+        }
+        pending.clear();
+    };
+
+    // With a coverage mask, whether area is still missing coverage is found
+    // by rasterizing chart coverage. Exact polygon differencing is then only
+    // needed for the area each following chart (or default land) fills, as
+    // less detailed charts must not draw over more detailed ones.
+    std::optional<coverage_mask> mask;
+    if (coverage_cells_ > 0)
+    {
+        mask.emplace(bbox, coverage_cells_, coverage_cells_);
+        if (rect == nullptr)
+        {
+            mask->restrict(*area);
+        }
+    }
+    bool covered = false;
+
+    // Plan which charts are used, and the area each one fills, from chart
+    // coverage alone. Features are then clipped separately per chart.
+    std::vector<chart_job> jobs;
+    jobs.reserve(selected.size());
+    for (std::size_t n = 0; n < selected.size(); n++)
+    {
+        // Prefer the chart store (with geometry generalized for the scale),
+        // only opening the chart itself without one, or if the sink needs
+        // all attributes at full resolution
+        stage_timer open_timer(stats, export_stats::OPEN);
+        jobs.emplace_back();
+        chart_job &job = jobs.back();
+        const metadata *chart = charts->ordered[selected[n]];
+        LOG_DEBUG(" - Process: %s", chart->path.stem().string().c_str());
+        job.store = sink.use_stores() ? charts->stores[selected[n]].get() : nullptr;
+        if (!job.store)
+        {
+            job.lease.emplace(datasets_.open(*chart));
+        }
+        open_timer.stop();
+        if (stats != nullptr)
+        {
+            stats->charts_opened++;
+            job.lstats.resize(layers.size());
+        }
+
+        // Skip charts only covering area already covered
+        stage_timer coverage_timer(stats, export_stats::COVERAGE);
+        OGRMultiPolygon coverage;
+        if (job.store)
+        {
+            get_store_coverage(coverage, *job.store);
+        }
+        else
+        {
+            get_chart_coverage(coverage, job.lease->get());
+        }
+        if (mask && (mask->add(coverage) == 0))
+        {
+            LOG_DEBUG(" - No new coverage (SKIP)");
+            jobs.pop_back();
+            if (stats != nullptr)
+            {
+                stats->charts_skipped++;
+            }
+            continue;
+        }
+
+        // Area still missing coverage is this chart's to fill
+        remove_coverage();
+        for (std::size_t i = 0; i < bounds.size(); i++)
+        {
+            job.regions.push_back(get_region(i));
+        }
+
+        // Chart coverage is no longer missing (without a mask, the exact
+        // remainder is needed now to tell if all is covered)
+        pending.push_back(std::move(coverage));
+        if (mask)
+        {
+            covered = mask->full();
+        }
+        else
+        {
+            remove_coverage();
+            covered = residue->IsEmpty();
+        }
+        coverage_timer.stop();
+
+        // Stop if all coverage is accounted for ...
+        if (covered)
+        {
+            LOG_DEBUG(" - Complete coverage (STOP)");
+            if (stats != nullptr)
+            {
+                stats->charts_skipped += selected.size() - (n + 1);
+            }
+            break;
+        }
+    }
 
-    // Check default land layer
-    GDALDataset *ids = GDALDataset::Open(land_file_name_.c_str(),
-                                         GDAL_OF_VECTOR | GDAL_OF_READONLY,
-                                         nullptr, nullptr, nullptr);
-    if (ids == nullptr)
+    // Clip a chart's layers to its planned region
+    auto clip_chart = [&](export_sink &out, chart_job &job) {
+        for (std::size_t i = 0; i < layers.size(); i++)
+        {
+            // Inland charts may not have certain features like depth
+            // contours. If not present, just skip and move on
+            export_stats::layer_stats *lstats = job.lstats.empty() ? nullptr : &job.lstats[i];
+            if (job.store)
+            {
+                const chart_store::layer *slayer =
+                    job.store->find_layer(layers[i].name, scale_min);
+                if (slayer != nullptr)
+                {
+                    clip_features(out, i, layers[i], *slayer, job.regions[layer_bounds[i]],
+                                  lstats);
+                }
+            }
+            else
+            {
+                OGRLayer *ilayer = job.lease->get()->GetLayerByName(layers[i].name.c_str());
+                if (ilayer != nullptr)
+                {
+                    clip_features(out, i, layers[i], ilayer, job.regions[layer_bounds[i]],
+                                  lstats);
+                }
+            }
+        }
+    };
+
+    // Clip charts, in parallel if enabled. Each chart's features are then
+    // merged in chart order, so output matches clipping one at a time.
+    stage_timer clip_timer(stats, export_stats::CLIP);
+    std::size_t threads = std::min<std::size_t>(
+        (clip_threads_ > 0) ? clip_threads_ : std::thread::hardware_concurrency(),
+        jobs.size());
+    if (threads <= 1)
     {
-        printf(" - Default land disabled, cannot open: %s\n", land_file_name_.c_str());
-        land_file_name_.clear();
-        land_layer_name_.clear();
+        for (chart_job &job : jobs)
+        {
+            clip_chart(sink, job);
+        }
     }
     else
     {
-        // If no layer specified, use first
-        if (land_layer_name_.empty())
+        std::vector<buffer_sink> buffers(jobs.size());
+        std::vector<std::exception_ptr> errors(jobs.size());
+        std::atomic<std::size_t> next_job(0);
+        auto worker = [&]() {
+            std::size_t n;
+            while ((n = next_job++) < jobs.size())
+            {
+                try
+                {
+                    clip_chart(buffers[n], jobs[n]);
+                }
+                catch (...)
+                {
+                    errors[n] = std::current_exception();
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (std::size_t t = 1; t < threads; t++)
+        {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (std::thread &next : workers)
         {
-            land_layer_name_ = ids->GetLayer(0)->GetName();
+            next.join();
         }
 
-        // Cleanup
-        printf(" - Default land loaded: %s [%s]\n",
-               land_file_name_.c_str(), land_layer_name_.c_str());
-        delete ids;
+        for (std::size_t n = 0; n < jobs.size(); n++)
+        {
+            if (errors[n])
+            {
+                std::rethrow_exception(errors[n]);
+            }
+            buffers[n].replay(sink);
+        }
     }
-}
-
-/**
- * Clear Chart Index
- */
-void enc_dataset::clear()
-{
-    charts_.clear();
-}
+    clip_timer.stop();
 
-/**
- * Recursively Load ENC Charts
- *
- * \param[in] enc_root ENC_ROOT base directory
- */
-void enc_dataset::load_charts(const std::string &enc_root)
-{
-    auto rdi = std::filesystem::recursive_directory_iterator(enc_root);
-    for (const std::filesystem::directory_entry &entry : rdi)
+    // Sum per chart layer statistics
+    if (stats != nullptr)
     {
-        if (entry.path().extension() == ".000")
+        for (const chart_job &job : jobs)
         {
-           load_chart(entry.path());
+            for (std::size_t i = 0; i < layers.size(); i++)
+            {
+                stats->layers[i].features_in += job.lstats[i].features_in;
+                stats->layers[i].features_out += job.lstats[i].features_out;
+            }
         }
     }
 
-    printf("%lu charts loaded\n", charts_.size());
-}
+    // If there's still missing coverage, attempt to use background land mass
+    // to fill in any holes in LNDARE layer
+    auto land = std::find_if(layers.begin(), layers.end(),
+                             [](const layer_spec &spec) { return spec.name == "LNDARE"; });
+    if (!land_.empty() && !covered && (land != layers.end()))
+    {
+        // Only pieces intersecting the area are touched, and they are drawn
+        // fill only so cell edges between pieces never show
+        stage_timer land_timer(stats, export_stats::LAND);
+        export_stats::layer_stats *lstats = get_layer_stats(stats, land - layers.begin());
+        remove_coverage();
+        clip_region region = get_region(layer_bounds[land - layers.begin()]);
+        std::vector<std::unique_ptr<OGRGeometry>> pieces;
+        land_.query(pieces, region.bbox());
+        std::size_t count = 0;
+        for (std::unique_ptr<OGRGeometry> &piece : pieces)
+        {
+            std::unique_ptr<OGRGeometry> clipped = region.clip(std::move(piece));
+            if (clipped)
+            {
+                sink.add_feature(land - layers.begin(), std::move(clipped), false);
+                count++;
+            }
+        }
+        if (lstats != nullptr)
+        {
+            lstats->features_in += pieces.size();
+            lstats->features_out += count;
+        }
+    }
 
-/**
- * Load Single ENC Chart
- *
- * \param[in] path Path to ENC chart
- */
-bool enc_dataset::load_chart(const std::filesystem::path &path)
-{
-    return load_chart_cache(path) || load_chart_disk(path);
+    return true;
 }
 
 /**
- * Export ENC Data to Empty Dataset
+ * Get Current Chart Set
  *
- * Creates specified layers in output dataset, populating with best data
- * available for given bounding box and minimum presentation scale.
- *
- * \param[out] ds Output dataset
- * \param[in] layers Specified ENC layers (S57)
- * \param[in] bbox Data bounding box (deg)
- * \param[in] scale_min Minimum data compilation scale
- * \return False if no data available
+ * \return Chart set snapshot
  */
-bool enc_dataset::export_data(GDALDataset *ods, const std::vector<std::string> &layers,
-                              const OGREnvelope &bbox, int scale_min)
+std::shared_ptr<const enc_dataset::chart_set> enc_dataset::get_charts() const
 {
-    // Define polygon boundary first
-    OGRLinearRing ring;
-    ring.addPoint(bbox.MinX, bbox.MinY);
-    ring.addPoint(bbox.MaxX, bbox.MinY);
-    ring.addPoint(bbox.MaxX, bbox.MaxY);
-    ring.addPoint(bbox.MinX, bbox.MaxY);
-    ring.addPoint(bbox.MinX, bbox.MinY);
-
-    // Define the polygon
-    OGRPolygon poly;
-    poly.addRing(&ring);
-
-    return export_data(ods, layers, poly, scale_min);
+    return std::atomic_load(&charts_);
 }
 
 /**
- * Export ENC Data to Empty Dataset
+ * Index and Publish Chart Set
  *
- * Creates specified layers in output dataset, populating with best data
- * available for given bounding box and minimum presentation scale.
+ * Charts whose recorded chart store cannot be mapped are marked as
+ * having none, so they are parsed again when next indexed.
  *
- * \param[out] ds Output dataset
- * \param[in] layers Specified ENC layers (S57)
- * \param[in] poly Data bounds (deg)
- * \param[in] scale_min Minimum data compilation scale
- * \return False if no data available
+ * \param[in] charts Chart metadata by chart name (stem)
+ * \return Published chart set
  */
-bool enc_dataset::export_data(GDALDataset *ods, const std::vector<std::string> &layers,
-                              const OGRPolygon &poly, int scale_min)
+std::shared_ptr<const enc_dataset::chart_set>
+enc_dataset::publish(std::map<std::string, metadata> charts)
 {
-    // Query bounding box
-    OGREnvelope bbox;
-    poly.getEnvelope(&bbox);
-
-    printf("Filter: Scale=%d, BBOX=(%g to %g),(%g to %g)\n",
-           scale_min, bbox.MinX, bbox.MaxX, bbox.MinY, bbox.MaxY);
-
-    // Build list of suitable charts
-    std::vector<const metadata*> selected;
-    for (const auto &[name, chart] : charts_)
+    auto next = std::make_shared<chart_set>();
+    next->charts = std::move(charts);
+
+    // Map chart stores up front, reusing those of the previous set where
+    // unchanged, so requests never need to modify the set
+    std::map<std::string, std::shared_ptr<const chart_store>> mapped;
+    std::shared_ptr<const chart_set> previous = get_charts();
+    if (previous)
     {
-        if ((scale_min <= chart.scale) && bbox.Intersects(chart.bbox))
+        for (std::size_t i = 0; i < previous->ordered.size(); i++)
         {
-            selected.push_back(&chart);
+            if (previous->stores[i])
+            {
+                mapped[previous->ordered[i]->path.string()] = previous->stores[i];
+            }
         }
     }
-    if (selected.empty() && land_file_name_.empty())
+    std::map<const metadata*, std::shared_ptr<const chart_store>> stores;
+    for (auto &[name, chart] : next->charts)
     {
-        return false;
+        std::shared_ptr<const chart_store> store = get_store(chart, mapped);
+        if (use_store_ && !store && (chart.store_version != 0))
+        {
+            LOG_WARN("Chart store missing or stale: %s", get_store_path(chart).c_str());
+            chart.store_version = 0;
+        }
+        stores[&chart] = std::move(store);
     }
 
-    // Sort in ascending scale order (most detailed first)
-    std::sort(selected.begin(), selected.end(),
-              [](const metadata* a, const metadata* b) {
-                  return a->scale < b->scale;});
+    // Index in ascending scale order (most detailed first), with ties in
+    // chart name order, so query results need no further sorting
+    for (const auto &[name, chart] : next->charts)
+    {
+        next->ordered.push_back(&chart);
+    }
+    std::stable_sort(next->ordered.begin(), next->ordered.end(),
+                     [](const metadata* a, const metadata* b) {
+                         return a->scale < b->scale;});
 
-    // Dump what we have to screen
-    printf("Selected %lu/%lu charts:\n", selected.size(), charts_.size());
-    for (const auto &chart : selected)
+    std::vector<chart_index::entry> entries;
+    entries.reserve(next->ordered.size());
+    for (const metadata *chart : next->ordered)
     {
-        printf(" - (%d) %s\n", chart->scale, chart->path.c_str());
+        entries.push_back({chart->bbox, chart->scale});
     }
+    next->index.build(entries);
 
-    // Create a new temp dataset for working
-    auto temp_ds = create_temp_dataset();
+    // Coverage polygons for selection (only read by requests, never changed)
+    next->areas.reserve(next->ordered.size());
+    for (const metadata *chart : next->ordered)
+    {
+        OGRGeometry *area = nullptr;
+        if (!chart->coverage_wkb.empty() &&
+            (OGRGeometryFactory::createFromWkb(chart->coverage_wkb.data(), nullptr, &area,
+                                               chart->coverage_wkb.size()) != OGRERR_NONE))
+        {
+            area = nullptr;
+        }
+        next->areas.emplace_back(area);
+    }
 
-    // Create layers in output dataset
-    for (const std::string &layer_name : layers)
+    next->stores.reserve(next->ordered.size());
+    for (const metadata *chart : next->ordered)
     {
-        create_layer(ods, layer_name.c_str());
+        next->stores.push_back(std::move(stores[chart]));
     }
 
-    // Going to need 3 working layers
-    OGRLayer *clip_layer = create_layer(temp_ds.get(), "");
-    OGRLayer *coverage_layer = create_layer(temp_ds.get(), "");
-    OGRLayer *result_layer = create_layer(temp_ds.get(), "");
+    // Swap in for new requests
+    std::shared_ptr<const chart_set> current = std::move(next);
+    std::atomic_store(&charts_, current);
+    return current;
+}
 
-    // Clip layer will track missing coverage
-    create_poly_feature(clip_layer, poly);
+/**
+ * Update Changed ENC Charts
+ *
+ * \param[in] files Changed chart files
+ */
+void enc_dataset::update_charts(const std::set<std::filesystem::path> &files)
+{
+    std::lock_guard<std::mutex> lock(update_mutex_);
 
-    // Process charts one at a time to reduce repeated S57 parses
-    for (const auto &chart : selected)
+    // Reduce changed files (including updates) to affected charts
+    std::set<std::filesystem::path> changed;
+    for (const std::filesystem::path &file : files)
     {
-        // Open input data set
-        printf(" - Process: %s\n", chart->path.stem().string().c_str());
-        GDALDataset *ids = GDALDataset::Open(chart->path.string().c_str(),
-                                             GDAL_OF_VECTOR | GDAL_OF_READONLY,
-                                             nullptr, nullptr, nullptr);
-        CHECKNULL(ids, "Cannot open input data set");
-
-        // Process chart's layers
-        for (const std::string &layer_name : layers)
+        if (is_s57_file(file))
         {
-            // NOTE: Some OGR drivers need to be done in sequence, and don't
-            // like us jumping around betwen layers, like KML ...
-            OGRLayer *olayer = ods->GetLayerByName(layer_name.c_str());
-            if (olayer == nullptr)
-            {
-                throw std::runtime_error("Cannot open output layer (OGR interleaving issue?)");
-            }
-
-            // Get input layer
-            OGRLayer *ilayer = ids->GetLayerByName(layer_name.c_str());
-            if (ilayer == nullptr)
-            {
-                // Inland charts may not have certain features like depth
-                // contours. If not present, just skip and move on
-                continue;
-            }
-
-            // Copy over features
-            if (ilayer->Clip(clip_layer, olayer) != OGRERR_NONE)
-            {
-                throw std::runtime_error("Cannot perform layer clip operation");
-            }
+            std::filesystem::path base = file;
+            changed.insert(base.replace_extension(".000"));
         }
+    }
+    if (changed.empty())
+    {
+        return;
+    }
 
-        // Remove any coverage from the clipping layer
-        copy_chart_coverage(coverage_layer, ids);
-        if (clip_layer->Erase(coverage_layer, result_layer) != OGRERR_NONE)
+    // Re-index just those charts, starting from the current set
+    std::map<std::string, metadata> charts = get_charts()->charts;
+    std::size_t parsed_count = 0;
+    for (const std::filesystem::path &path : changed)
+    {
+        std::string name = path.stem().string();
+        auto it = charts.find(name);
+        if ((it != charts.end()) && (it->second.path == path))
         {
-            throw std::runtime_error("Cannot perform layer erase operation");
+            charts.erase(it);
         }
-        std::swap(clip_layer, result_layer);
-        clear_layer(coverage_layer);
-        clear_layer(result_layer);
 
-        // Close input dataset
-        delete ids;
-
-        // Stop if all coverage is accounted for ...
-        if (clip_layer->GetFeatureCount() == 0)
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec))
         {
-            printf(" - Complete coverage (STOP)\n");
-            break;
+            LOG_INFO("Chart removed: %s", path.c_str());
+            continue;
         }
-    }
-
-    // If there's still missing coverage, attempt to use background land mass
-    // to fill in any holes in LNDARE layer
-    if ((!land_file_name_.empty()) && (clip_layer->GetFeatureCount() != 0))
-    {
-        // Open input data set
-        GDALDataset *ids = GDALDataset::Open(land_file_name_.c_str(),
-                                             GDAL_OF_VECTOR | GDAL_OF_READONLY,
-                                             nullptr, nullptr, nullptr);
-        CHECKNULL(ids, "Cannot open input data set");
-        OGRLayer *ilayer = ids->GetLayerByName(land_layer_name_.c_str());
-        CHECKNULL(ilayer, "Cannot get BG input layer");
 
-        // Copy features
-        OGRLayer *olayer = ods->GetLayerByName("LNDARE");
-        if (ilayer->Clip(clip_layer, olayer) != OGRERR_NONE)
+        try
+        {
+            metadata next;
+            next.path = path;
+            add_fingerprints(next);
+            bool parsed = false;
+            if (index_chart(next, parsed))
+            {
+                LOG_INFO("Chart updated: %s", path.c_str());
+                charts[name] = std::move(next);
+                parsed_count += parsed;
+            }
+        }
+        catch (const std::exception &e)
         {
-            delete ids;
-            return false;
+            LOG_WARN("Cannot index %s: %s", path.c_str(), e.what());
         }
-
-        // Cleanup
-        delete ids;
     }
 
-    return true;
+    auto current = publish(std::move(charts));
+    save_metadata(*current);
+    LOG_INFO("%lu charts loaded (%lu parsed)", current->charts.size(), parsed_count);
 }
 
 /**
- * Save Single ENC Chart To Cache
+ * Index Single ENC Chart
  *
- * \param[in] path Path to ENC chart
+ * Cached metadata is used only if its fingerprint (file size and time)
+ * still matches, and a current chart store was built if stores are in
+ * use, otherwise the chart is parsed again. Safe to call concurrently,
+ * as no dataset state is modified.
+ *
+ * \param[in,out] meta Chart metadata (with path and fingerprint set)
+ * \param[out] parsed Chart was parsed from disk (not cached)
  * \return False on failure
  */
-bool enc_dataset::save_chart_cache(const metadata &meta)
+bool enc_dataset::index_chart(metadata &meta, bool &parsed) const
 {
-    // Ensure cache directory exists
-    if (!std::filesystem::exists(cache_) &&
-        !std::filesystem::create_directories(cache_))
-    {
-        return false;
-    }
-
-    // Save to /path/to/cache/NAME ...
-    std::filesystem::path cached_path = cache_ / meta.path.stem();
-    std::ofstream handle(cached_path.string().c_str());
-    if (handle.good())
+    const metadata_file::record *cached = meta_file_.find(meta.path);
+    parsed = (cached == nullptr) || !metadata_file::matches(*cached, meta) ||
+        (use_store_ && (metadata_file::store_version(*cached) != chart_store::version));
+    if (!parsed)
     {
-        handle << meta.path << "\n" << meta.scale << "\n"
-               << meta.bbox.MinX << "\n" << meta.bbox.MaxX << "\n"
-               << meta.bbox.MinY << "\n" << meta.bbox.MaxY << "\n";
+        // Chart sets outlive the mapped file, so keep a copy
+        meta_file_.copy(*cached, meta);
+        return true;
     }
-
-    return handle.good();
+    return load_chart_disk(meta);
 }
 
 /**
- * Load Single ENC Chart from Cache
+ * Save Chart Metadata File
  *
- * \param[in] path Path to ENC chart
+ * Rewrites metadata file with given charts, and maps it.
+ *
+ * \param[in] current Chart set to save
  * \return False on failure
  */
-bool enc_dataset::load_chart_cache(const std::filesystem::path &path)
+bool enc_dataset::save_metadata(const chart_set &current)
 {
-    // Look for /path/to/cache/NAME ...
-    std::filesystem::path cached_path = cache_ / path.stem();
-    if (std::filesystem::exists(cached_path))
+    std::vector<const metadata*> charts;
+    charts.reserve(current.charts.size());
+    for (const auto &[name, chart] : current.charts)
     {
-        // Try and read it
-        std::ifstream handle(cached_path.string().c_str());
-        if (handle.good())
-        {
-            metadata next;
-            handle >> next.path >> next.scale
-                   >> next.bbox.MinX >> next.bbox.MaxX
-                   >> next.bbox.MinY >> next.bbox.MaxY;
-
-            // Ensure no EOF, and path matches before saving metadata
-            if (handle.good() && (path == next.path))
-            {
-                charts_[path.stem().string()] = next;
-                return true;
-            }
-        }
+        charts.push_back(&chart);
     }
 
-    // Failed to load
-    return false;
+    std::filesystem::path meta_path = cache_ / "charts.idx";
+    if (!metadata_file::write(meta_path, charts))
+    {
+        LOG_WARN("Cannot write chart metadata: %s", meta_path.c_str());
+        return false;
+    }
+    return meta_file_.open(meta_path);
 }
 
 /**
  * Load Single ENC Chart from Disk
  *
- * \param[in] path Path to ENC chart
+ * \param[in,out] meta Chart metadata (with path and fingerprint set)
  * \return False on failure
  */
-bool enc_dataset::load_chart_disk(const std::filesystem::path &path)
+bool enc_dataset::load_chart_disk(metadata &meta) const
 {
+    const std::filesystem::path &path = meta.path;
     metadata next = {path};
+    next.file_size = meta.file_size;
+    next.file_time = meta.file_time;
 
     // Open dataset
     const char *const drivers[] = { "S57", nullptr };
-    GDALDataset *ds = GDALDataset::Open(path.string().c_str(),
-                                        GDAL_OF_VECTOR | GDAL_OF_READONLY,
-                                        drivers, nullptr, nullptr);
+    std::unique_ptr<GDALDataset> ds(GDALDataset::Open(path.string().c_str(),
+                                                      GDAL_OF_VECTOR | GDAL_OF_READONLY,
+                                                      drivers, nullptr, nullptr));
     CHECKNULL(ds, "Cannot open OGR dataset");
 
     // Get Compilation Scale of Chart
@@ -394,6 +1641,11 @@ bool enc_dataset::load_chart_disk(const std::filesystem::path &path)
 
         // .. that has "Dataset Parameter" (DSPM) "Compilation of Scale" (CSCL)
         next.scale = get_feat_field_int(feat.get(), "DSPM_CSCL");
+
+        // .. as well as "Edition Number" (EDTN) and "Update Number" (UPDN),
+        // which are encoded as text
+        next.edition = feat->GetFieldAsInteger("DSID_EDTN");
+        next.update = feat->GetFieldAsInteger("DSID_UPDN");
     }
 
     // Get Chart Coverage Bounds
@@ -404,6 +1656,7 @@ bool enc_dataset::load_chart_disk(const std::filesystem::path &path)
 
         // There's probably only one coverage feature,
         // but just in case, combine any we find
+        OGRMultiPolygon area;
         for (auto &feat : layer)
         {
             // "Category of Coverage" (CATCOV) may be:
@@ -414,26 +1667,94 @@ bool enc_dataset::load_chart_disk(const std::filesystem::path &path)
 
             // Get coverage for this feature
             OGRGeometry *geo = feat->GetGeometryRef();
-            CHECKNULL(layer, "Cannot get feature geometry");
+            CHECKNULL(geo, "Cannot get feature geometry");
 
             // There's probably only one coverage feature,
             // but in case there's not merge each one
             OGREnvelope covr;
             geo->getEnvelope(&covr);
             next.bbox.Merge(covr);
+            next.coverage.push_back(covr);
+            add_polygons(area, geo);
         }
-    }
 
-    // Cleanup
-    delete ds;
+        // Keep a simplified coverage polygon for chart selection, grown
+        // first so that it never excludes any actual coverage
+        if (!area.IsEmpty())
+        {
+            std::unique_ptr<OGRGeometry> grown(area.Buffer(coverage_tolerance));
+            std::unique_ptr<OGRGeometry> simple(
+                grown ? grown->SimplifyPreserveTopology(coverage_tolerance) : nullptr);
+            if (simple)
+            {
+                next.coverage_wkb.resize(simple->WkbSize());
+                simple->exportToWkb(wkbNDR, next.coverage_wkb.data());
+            }
+        }
+    }
 
-    // Save
-    charts_[path.stem().string()] = next;
-    save_chart_cache(next);
+    // Build chart store from the already opened chart
+    if (use_store_)
+    {
+        std::error_code ec;
+        std::filesystem::path store_path = get_store_path(next);
+        std::filesystem::create_directories(store_path.parent_path(), ec);
+        if (chart_store::write(store_path, next, ds.get()))
+        {
+            next.store_version = chart_store::version;
+        }
+        else
+        {
+            LOG_WARN("Cannot write chart store: %s", store_path.c_str());
+        }
+    }
 
+    meta = next;
     return true;
 }
 
+/**
+ * Get Chart Store Path
+ *
+ * \param[in] meta Chart metadata
+ * \return Path to chart store file
+ */
+std::filesystem::path enc_dataset::get_store_path(const metadata &meta) const
+{
+    return cache_ / "store" / (meta.path.stem().string() + ".bin");
+}
+
+/**
+ * Get Chart Store
+ *
+ * \param[in] meta Chart metadata
+ * \param[in] mapped Already mapped chart stores by chart path
+ * \return Mapped chart store, or nullptr if none is current
+ */
+std::shared_ptr<const chart_store> enc_dataset::get_store(
+    const metadata &meta,
+    const std::map<std::string, std::shared_ptr<const chart_store>> &mapped) const
+{
+    if (!use_store_)
+    {
+        return nullptr;
+    }
+
+    // Reuse mapping only while it matches chart fingerprint
+    auto it = mapped.find(meta.path.string());
+    if ((it != mapped.end()) && it->second->matches(meta))
+    {
+        return it->second;
+    }
+
+    auto store = std::make_shared<chart_store>();
+    if (store->open(get_store_path(meta)) && store->matches(meta))
+    {
+        return store;
+    }
+    return nullptr;
+}
+
 /**
  * Get OGR Integer Field
  *
@@ -467,44 +1788,68 @@ int enc_dataset::get_feat_field_int(OGRFeature *feat, const char *name)
 }
 
 /**
- * Create Temporary Dataset
+ * Check Attribute Is Wanted
  *
- * \return Created dataset
+ * \param[in] field Attribute name
+ * \return True if attribute should be exported
  */
-std::unique_ptr<GDALDataset> enc_dataset::create_temp_dataset()
+bool enc_dataset::layer_spec::wants(const char *field) const
 {
-    GDALDataset *ptr = mem_drv_->Create("", 0, 0, 0, GDT_Unknown, nullptr);
-    CHECKNULL(ptr, "Cannot create temporary dataset");
-    return std::unique_ptr<GDALDataset>(ptr);
+    return !fields.has_value() ||
+        (std::find(fields->begin(), fields->end(), field) != fields->end());
 }
 
 /**
- * Create Temporary Layer
+ * Layers With All Attributes
  *
- * \param[out] ds Dataset for layer
- * \param[in] name Name of layer
- * \return Created dataset
+ * \param[in] layers Layer names (S57)
+ * \return Layer specifications, keeping all attributes
  */
-OGRLayer *enc_dataset::create_layer(GDALDataset *ds, const char *name)
+std::vector<enc_dataset::layer_spec> enc_dataset::all_fields(const std::vector<std::string> &layers)
 {
-    OGRLayer *ptr = ds->CreateLayer(name);
-    CHECKNULL(ptr, "Cannot create dataset layer");
-    return ptr;
+    std::vector<layer_spec> specs;
+    for (const std::string &name : layers)
+    {
+        specs.push_back({ name, std::nullopt });
+    }
+    return specs;
+}
+
+/**
+ * Rectangle to Polygon
+ *
+ * \param[in] bbox Bounding box
+ * \return Polygon of bounding box
+ */
+OGRPolygon enc_dataset::rect_to_polygon(const OGREnvelope &bbox)
+{
+    // Define polygon boundary first
+    OGRLinearRing ring;
+    ring.addPoint(bbox.MinX, bbox.MinY);
+    ring.addPoint(bbox.MaxX, bbox.MinY);
+    ring.addPoint(bbox.MaxX, bbox.MaxY);
+    ring.addPoint(bbox.MinX, bbox.MaxY);
+    ring.addPoint(bbox.MinX, bbox.MinY);
+
+    // Define the polygon
+    OGRPolygon poly;
+    poly.addRing(&ring);
+    return poly;
 }
 
 /**
- * Copy ENC Chart Coverage
+ * Get ENC Chart Coverage
  *
- * \param[out] layer Output layer
+ * \param[out] area Coverage polygons
  * \param[in] ds Input dataset
  */
-void enc_dataset::copy_chart_coverage(OGRLayer *layer, GDALDataset *ds)
+void enc_dataset::get_chart_coverage(OGRMultiPolygon &area, GDALDataset *ds)
 {
     // Get "Coverage" (M_COVR) data
     OGRLayer *ilayer = ds->GetLayerByName("M_COVR");
     CHECKNULL(ilayer, "Cannot open M_COVR layer");
 
-    // Copy any defined coverage features
+    // Collect any defined coverage features
     for (auto &feat : ilayer)
     {
         // "Category of Coverage" (CATCOV) may be:
@@ -513,46 +1858,162 @@ void enc_dataset::copy_chart_coverage(OGRLayer *layer, GDALDataset *ds)
         if (get_feat_field_int(feat.get(), "CATCOV") != 1)
             continue;
 
-        // Create output feature
-        if (layer->CreateFeature(feat.get()) != OGRERR_NONE)
-        {
-            throw std::runtime_error("Cannot create coverage feature");
-        }
+        const OGRGeometry *geo = feat->GetGeometryRef();
+        CHECKNULL(geo, "Cannot get feature geometry");
+        add_polygons(area, geo);
+    }
+}
+
+/**
+ * Get Chart Store Coverage
+ *
+ * \param[out] area Coverage polygons
+ * \param[in] store Chart store
+ */
+void enc_dataset::get_store_coverage(OGRMultiPolygon &area, const chart_store &store)
+{
+    // Get "Coverage" (M_COVR) data
+    const chart_store::layer *slayer = store.find_layer("M_COVR");
+    CHECKNULL(slayer, "Cannot open M_COVR layer");
+    int catcov = slayer->find_attr("CATCOV");
+    if (catcov < 0)
+    {
+        throw std::runtime_error("Feature does not have field \"CATCOV\"");
+    }
+
+    // Collect any defined coverage features
+    for (std::size_t i = 0; i < slayer->feature_count; i++)
+    {
+        // "Category of Coverage" (CATCOV) may be:
+        //  - "coverage available" (1)
+        //  - "no coverage available" (2)
+        if (slayer->attr(catcov, i) != 1)
+            continue;
+
+        add_polygons(area, slayer->geometry(i).get());
     }
 }
 
 /**
- * Clear Layer Features
+ * Clip Layer Features
  *
- * \param[out] layer OGR layer
+ * Features disjoint from the clip region are skipped by bounding box
+ * (using the layer spatial filter), and those fully within it are copied
+ * without clipping. Unwanted fields are ignored while reading.
+ *
+ * \param[out] sink Output features
+ * \param[in] olayer Output layer index
+ * \param[in] spec Output layer specification
+ * \param[in] ilayer Input layer
+ * \param[in] region Clip region
+ * \param[out] lstats Layer statistics (nullptr to skip)
  */
-void enc_dataset::clear_layer(OGRLayer *layer)
+void enc_dataset::clip_features(export_sink &sink, std::size_t olayer, const layer_spec &spec,
+                                OGRLayer *ilayer, const clip_region &region,
+                                export_stats::layer_stats *lstats)
 {
-    for (auto &feat : layer)
+    // Map wanted input fields to output, ignoring the rest
+    OGRFeatureDefn *idefn = ilayer->GetLayerDefn();
+    std::vector<int> fields(idefn->GetFieldCount(), -1);
+    std::vector<const char*> ignored;
+    for (int i = 0; i < idefn->GetFieldCount(); i++)
+    {
+        const OGRFieldDefn &defn = *idefn->GetFieldDefn(i);
+        if (spec.wants(defn.GetNameRef()))
+        {
+            fields[i] = sink.get_field(olayer, defn);
+        }
+        else
+        {
+            ignored.push_back(defn.GetNameRef());
+        }
+    }
+    ignored.push_back(nullptr);
+
+    // Let the driver skip features by bounding box, and unwanted fields
+    const OGREnvelope &bbox = region.bbox();
+    ilayer->SetSpatialFilterRect(bbox.MinX, bbox.MinY, bbox.MaxX, bbox.MaxY);
+    ilayer->SetIgnoredFields(ignored.data());
+    uint64_t count_in = 0, count_out = 0;
+    try
     {
-        if (layer->DeleteFeature(feat->GetFID()) != OGRERR_NONE)
+        for (auto &feat : ilayer)
         {
-            throw std::runtime_error("Cannot delete layer feature");
+            count_in++;
+            const OGRGeometry *geo = feat->GetGeometryRef();
+            std::unique_ptr<OGRGeometry> clipped;
+            if ((geo != nullptr) && (clipped = region.clip(*geo)))
+            {
+                sink.add_feature(olayer, std::move(clipped), *feat, fields);
+                count_out++;
+            }
         }
     }
+    catch (...)
+    {
+        ilayer->SetIgnoredFields(nullptr);
+        ilayer->SetSpatialFilter(nullptr);
+        throw;
+    }
+
+    // Input may be a cached chart, reused by later requests
+    ilayer->SetIgnoredFields(nullptr);
+    ilayer->SetSpatialFilter(nullptr);
+
+    if (lstats != nullptr)
+    {
+        lstats->features_in += count_in;
+        lstats->features_out += count_out;
+    }
 }
 
 /**
- * Polygon to Layer Feature
+ * Clip Chart Store Features
+ *
+ * Features disjoint from the clip region are skipped by bounding box
+ * before their geometry is built.
  *
- * \param[out] layer GDAL output layer
- * \param[in] poly OGR Polygon
+ * \param[out] sink Output features
+ * \param[in] olayer Output layer index
+ * \param[in] spec Output layer specification
+ * \param[in] slayer Chart store layer
+ * \param[in] region Clip region
+ * \param[out] lstats Layer statistics (nullptr to skip)
  */
-void enc_dataset::create_poly_feature(OGRLayer *layer, const OGRPolygon &poly)
+void enc_dataset::clip_features(export_sink &sink, std::size_t olayer, const layer_spec &spec,
+                                const chart_store::layer &slayer,
+                                const clip_region &region,
+                                export_stats::layer_stats *lstats)
 {
-    // Create a feature based on the output layer
-    OGRFeature feat(layer->GetLayerDefn());
-    feat.SetGeometry(&poly);
+    // Numeric attributes are all stored as reals
+    std::vector<int> fields;
+    for (const std::string &name : slayer.attr_names)
+    {
+        OGRFieldDefn defn(name.c_str(), OFTReal);
+        fields.push_back(spec.wants(name.c_str()) ? sink.get_field(olayer, defn) : -1);
+    }
+
+    const OGREnvelope &bbox = region.bbox();
+    uint64_t count_in = 0, count_out = 0;
+    for (std::size_t i = 0; i < slayer.feature_count; i++)
+    {
+        if (!bbox.Intersects(slayer.bbox(i)))
+        {
+            continue;
+        }
+        count_in++;
+        std::unique_ptr<OGRGeometry> clipped = region.clip(slayer.geometry(i));
+        if (clipped)
+        {
+            sink.add_feature(olayer, std::move(clipped), slayer, i, fields);
+            count_out++;
+        }
+    }
 
-    // Add to layer
-    if (layer->CreateFeature(&feat) != OGRERR_NONE)
+    if (lstats != nullptr)
     {
-        throw std::runtime_error("Cannot create layer feature");
+        lstats->features_in += count_in;
+        lstats->features_out += count_out;
     }
 }
 
@@ -0,0 +1,122 @@
+/**
+ * \file
+ * \brief ENC Export Statistics
+ *
+ * Counters and per stage timing filled in by enc_dataset exports, when
+ * requested. Stats from many exports may be summed for reporting.
+ */
+
+#include <cstdio>
+#include <encdata/export_stats.h>
+
+namespace encdata
+{
+
+/**
+ * Clear Statistics
+ */
+void export_stats::clear()
+{
+    *this = export_stats();
+}
+
+/**
+ * Add Statistics
+ *
+ * Layers are matched by name.
+ *
+ * \param[in] other Statistics to add
+ */
+void export_stats::add(const export_stats &other)
+{
+    exports += other.exports;
+    charts_considered += other.charts_considered;
+    charts_selected += other.charts_selected;
+    charts_opened += other.charts_opened;
+    charts_skipped += other.charts_skipped;
+    for (int i = 0; i < STAGE_COUNT; i++)
+    {
+        stage_ns[i] += other.stage_ns[i];
+    }
+
+    for (const layer_stats &olayer : other.layers)
+    {
+        layer_stats *match = nullptr;
+        for (layer_stats &next : layers)
+        {
+            if (next.name == olayer.name)
+            {
+                match = &next;
+                break;
+            }
+        }
+        if (match == nullptr)
+        {
+            layers.push_back({ olayer.name });
+            match = &layers.back();
+        }
+        match->features_in += olayer.features_in;
+        match->features_out += olayer.features_out;
+    }
+}
+
+/**
+ * Get Stage Name
+ *
+ * \param[in] s Export stage
+ * \return Stage name
+ */
+const char *export_stats::stage_name(stage s)
+{
+    switch (s)
+    {
+        case SELECT:
+            return "select";
+        case OPEN:
+            return "open";
+        case CLIP:
+            return "clip";
+        case COVERAGE:
+            return "coverage";
+        case LAND:
+            return "land";
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * Format as Text
+ *
+ * \return Human readable summary
+ */
+std::string export_stats::to_string() const
+{
+    std::string out;
+    char line[256];
+
+    snprintf(line, sizeof(line),
+             "exports: %lu\n"
+             "charts: considered=%lu selected=%lu opened=%lu skipped=%lu\n",
+             (unsigned long)exports, (unsigned long)charts_considered,
+             (unsigned long)charts_selected, (unsigned long)charts_opened,
+             (unsigned long)charts_skipped);
+    out += line;
+
+    for (int i = 0; i < STAGE_COUNT; i++)
+    {
+        snprintf(line, sizeof(line), "stage %s: %.3f ms\n",
+                 stage_name((stage)i), stage_ns[i] / 1e6);
+        out += line;
+    }
+
+    for (const layer_stats &next : layers)
+    {
+        snprintf(line, sizeof(line), "layer %s: in=%lu out=%lu\n", next.name.c_str(),
+                 (unsigned long)next.features_in, (unsigned long)next.features_out);
+        out += line;
+    }
+    return out;
+}
+
+}; // ~namespace encdata
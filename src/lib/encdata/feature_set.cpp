@@ -0,0 +1,231 @@
+/**
+ * \file
+ * \brief ENC Feature Set
+ *
+ * Lean container of exported features, with geometry held in flat
+ * coordinate arrays and numeric attributes in columns. Storage is kept
+ * when cleared, so a reused set stops allocating once warmed up.
+ */
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <encdata/feature_set.h>
+
+namespace encdata
+{
+
+/// Value of unset attributes
+static constexpr double no_value = std::numeric_limits<double>::quiet_NaN();
+
+/**
+ * Clear Features
+ *
+ * Storage is kept for reuse.
+ *
+ * \param[in] name New layer name
+ */
+void feature_set::layer::clear(const std::string &name)
+{
+    name_ = name;
+    features.clear();
+    parts.clear();
+    x.clear();
+    y.clear();
+    z.clear();
+    attr_names_.clear();
+    for (std::vector<double> &values : attr_values_)
+    {
+        values.clear();
+    }
+}
+
+/**
+ * Get Layer Name
+ *
+ * \return Layer name
+ */
+const std::string &feature_set::layer::name() const
+{
+    return name_;
+}
+
+/**
+ * Add Numeric Attribute
+ *
+ * Existing features have no value (NaN) for new attributes.
+ *
+ * \param[in] name Attribute name
+ * \return Attribute index
+ */
+std::size_t feature_set::layer::add_attr(const std::string &name)
+{
+    int idx = find_attr(name.c_str());
+    if (idx >= 0)
+    {
+        return idx;
+    }
+
+    // Reuse a cleared column if there is one
+    attr_names_.push_back(name);
+    if (attr_values_.size() < attr_names_.size())
+    {
+        attr_values_.emplace_back();
+    }
+    attr_values_[attr_names_.size() - 1].assign(features.size(), no_value);
+    return attr_names_.size() - 1;
+}
+
+/**
+ * Find Numeric Attribute
+ *
+ * \param[in] name Attribute name
+ * \return Attribute index, or -1 if not present
+ */
+int feature_set::layer::find_attr(const char *name) const
+{
+    for (std::size_t i = 0; i < attr_names_.size(); i++)
+    {
+        if (attr_names_[i] == name)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Add Feature
+ *
+ * Collections are flattened into their component parts, and anything
+ * other than points, lines, and polygons is dropped.
+ *
+ * \param[in] geo Feature geometry
+ * \param[in] outline Draw polygon outlines
+ * \return Feature index (attributes initially NaN)
+ */
+std::size_t feature_set::layer::add_feature(const OGRGeometry &geo, bool outline)
+{
+    feature next;
+    next.part_first = parts.size();
+    next.is_3d = geo.Is3D();
+    add_geometry_parts(parts, x, y, z, geo);
+    next.outline = outline;
+    next.part_count = parts.size() - next.part_first;
+    features.push_back(next);
+    for (std::size_t i = 0; i < attr_names_.size(); i++)
+    {
+        attr_values_[i].push_back(no_value);
+    }
+    return features.size() - 1;
+}
+
+/**
+ * Set Attribute Value
+ *
+ * \param[in] idx Feature index
+ * \param[in] attr Attribute index
+ * \param[in] value Attribute value
+ */
+void feature_set::layer::set_attr(std::size_t idx, std::size_t attr, double value)
+{
+    attr_values_[attr][idx] = value;
+}
+
+/**
+ * Get Attribute Value
+ *
+ * \param[in] idx Feature index
+ * \param[in] attr Attribute index (may be -1)
+ * \return Attribute value (NaN if unset)
+ */
+double feature_set::layer::attr(std::size_t idx, int attr) const
+{
+    return (attr < 0) ? no_value : attr_values_[attr][idx];
+}
+
+/**
+ * Get Feature Count
+ *
+ * \return Number of features
+ */
+std::size_t feature_set::layer::size() const
+{
+    return features.size();
+}
+
+/**
+ * Constructor
+ */
+feature_set::feature_set()
+    : count_(0)
+{
+}
+
+/**
+ * Clear All Layers
+ *
+ * Storage is kept for reuse.
+ */
+void feature_set::clear()
+{
+    count_ = 0;
+}
+
+/**
+ * Add Layer
+ *
+ * \param[in] name Layer name
+ * \return Empty layer
+ */
+feature_set::layer &feature_set::add_layer(const std::string &name)
+{
+    if (count_ == layers_.size())
+    {
+        layers_.emplace_back();
+    }
+    layer &next = layers_[count_++];
+    next.clear(name);
+    return next;
+}
+
+/**
+ * Find Layer
+ *
+ * \param[in] name Layer name
+ * \return Layer, or nullptr if not present
+ */
+const feature_set::layer *feature_set::find_layer(const std::string &name) const
+{
+    for (std::size_t i = 0; i < count_; i++)
+    {
+        if (layers_[i].name() == name)
+        {
+            return &layers_[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Get Layer Count
+ *
+ * \return Number of layers
+ */
+std::size_t feature_set::size() const
+{
+    return count_;
+}
+
+/**
+ * Get Layer
+ *
+ * \param[in] idx Layer index
+ * \return Layer
+ */
+feature_set::layer &feature_set::operator[](std::size_t idx)
+{
+    return layers_[idx];
+}
+
+}; // ~namespace encdata
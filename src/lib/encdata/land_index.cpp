@@ -0,0 +1,317 @@
+/**
+ * \file
+ * \brief Default Land Index
+ *
+ * Background land coverage (ie - GSHHS), loaded once and kept in memory.
+ * Polygons are split along a quadtree until each piece is small, so a tile
+ * only ever touches the few pieces that intersect it.
+ */
+
+#include <gdal_priv.h>
+#include <ogrsf_frmts.h>
+#include <encdata/land_index.h>
+
+namespace encdata
+{
+
+/**
+ * Add Polygons to Area
+ *
+ * Anything other than polygons (ie - touching edges) is dropped.
+ *
+ * \param[out] area Output area
+ * \param[in] geo Polygon, or collection of polygons
+ */
+static void add_polygons(OGRMultiPolygon &area, const OGRGeometry *geo)
+{
+    if (wkbFlatten(geo->getGeometryType()) == wkbPolygon)
+    {
+        area.addGeometry(geo);
+    }
+    else if (OGR_GT_IsSubClassOf(wkbFlatten(geo->getGeometryType()), wkbGeometryCollection))
+    {
+        const OGRGeometryCollection *coll = geo->toGeometryCollection();
+        for (int i = 0; i < coll->getNumGeometries(); i++)
+        {
+            add_polygons(area, coll->getGeometryRef(i));
+        }
+    }
+}
+
+/**
+ * Count Geometry Points
+ *
+ * \param[in] geo Polygon, or collection of polygons
+ * \return Number of points in all rings
+ */
+static std::size_t count_points(const OGRGeometry *geo)
+{
+    std::size_t count = 0;
+    if (wkbFlatten(geo->getGeometryType()) == wkbPolygon)
+    {
+        const OGRPolygon *poly = geo->toPolygon();
+        if (poly->getExteriorRing() != nullptr)
+        {
+            count += poly->getExteriorRing()->getNumPoints();
+        }
+        for (int i = 0; i < poly->getNumInteriorRings(); i++)
+        {
+            count += poly->getInteriorRing(i)->getNumPoints();
+        }
+    }
+    else if (OGR_GT_IsSubClassOf(wkbFlatten(geo->getGeometryType()), wkbGeometryCollection))
+    {
+        const OGRGeometryCollection *coll = geo->toGeometryCollection();
+        for (int i = 0; i < coll->getNumGeometries(); i++)
+        {
+            count += count_points(coll->getGeometryRef(i));
+        }
+    }
+    return count;
+}
+
+/**
+ * Rectangle to Polygon
+ *
+ * \param[in] bbox Bounding box
+ * \return Polygon of bounding box
+ */
+static OGRPolygon rect_to_polygon(const OGREnvelope &bbox)
+{
+    OGRLinearRing ring;
+    ring.addPoint(bbox.MinX, bbox.MinY);
+    ring.addPoint(bbox.MaxX, bbox.MinY);
+    ring.addPoint(bbox.MaxX, bbox.MaxY);
+    ring.addPoint(bbox.MinX, bbox.MaxY);
+    ring.addPoint(bbox.MinX, bbox.MinY);
+
+    OGRPolygon poly;
+    poly.addRing(&ring);
+    return poly;
+}
+
+/**
+ * Constructor
+ */
+land_index::land_index()
+{
+}
+
+/**
+ * Load Land Layer
+ *
+ * Replaces any previously loaded land.
+ *
+ * \param[in] file_name Path to land coverage file
+ * \param[in] layer_name Land coverage layer (first layer if empty)
+ * \return False if layer cannot be read
+ */
+bool land_index::load(const std::string &file_name, const std::string &layer_name)
+{
+    nodes_.clear();
+    pieces_.clear();
+
+    // Open input data set
+    std::unique_ptr<GDALDataset> ids(GDALDataset::Open(file_name.c_str(),
+                                                       GDAL_OF_VECTOR | GDAL_OF_READONLY,
+                                                       nullptr, nullptr, nullptr));
+    if (!ids)
+    {
+        return false;
+    }
+    OGRLayer *ilayer = layer_name.empty() ?
+        ids->GetLayer(0) : ids->GetLayerByName(layer_name.c_str());
+    OGREnvelope extent;
+    if ((ilayer == nullptr) || (ilayer->GetExtent(&extent, TRUE) != OGRERR_NONE))
+    {
+        return false;
+    }
+
+    // Split each polygon down from the full layer extent
+    nodes_.push_back({ extent, { 0, 0, 0, 0 }, {} });
+    for (auto &feat : ilayer)
+    {
+        const OGRGeometry *geo = feat->GetGeometryRef();
+        if (geo == nullptr)
+        {
+            continue;
+        }
+        OGRMultiPolygon polys;
+        add_polygons(polys, geo);
+        for (int i = 0; i < polys.getNumGeometries(); i++)
+        {
+            insert(0, 0, std::unique_ptr<OGRGeometry>(polys.getGeometryRef(i)->clone()));
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Check If Empty
+ *
+ * \return True if no land is loaded
+ */
+bool land_index::empty() const
+{
+    return pieces_.empty();
+}
+
+/**
+ * Query Land Polygons
+ *
+ * Pieces are returned as split, not merged back together, so their outlines
+ * include quadtree cell edges. Draw them fill only.
+ *
+ * \param[out] out Land polygons intersecting bounding box (replaced)
+ * \param[in] bbox Query bounding box (deg)
+ * \return Number of pieces checked against bounding box
+ */
+std::size_t land_index::query(std::vector<std::unique_ptr<OGRGeometry>> &out,
+                              const OGREnvelope &bbox) const
+{
+    out.clear();
+    if (nodes_.empty())
+    {
+        return 0;
+    }
+
+    // Collect intersecting pieces, as split
+    std::size_t checked = 0;
+    std::vector<uint32_t> pending = { 0 };
+    while (!pending.empty())
+    {
+        const node &next = nodes_[pending.back()];
+        pending.pop_back();
+        if (!next.bbox.Intersects(bbox))
+        {
+            continue;
+        }
+        checked += next.pieces.size();
+        for (uint32_t idx : next.pieces)
+        {
+            if (pieces_[idx].bbox.Intersects(bbox))
+            {
+                out.emplace_back(pieces_[idx].geo->clone());
+            }
+        }
+        for (uint32_t child : next.children)
+        {
+            if (child != 0)
+            {
+                pending.push_back(child);
+            }
+        }
+    }
+    return checked;
+}
+
+/**
+ * Get Child Node
+ *
+ * \param[in] parent Parent node index
+ * \param[in] quadrant Child quadrant (0 to 3)
+ * \return Child node index, created if missing
+ */
+uint32_t land_index::get_child(uint32_t parent, int quadrant)
+{
+    if (nodes_[parent].children[quadrant] == 0)
+    {
+        // Quadrants are numbered by X (bit 0) and Y (bit 1) half
+        OGREnvelope bbox = nodes_[parent].bbox;
+        double mid_x = (bbox.MinX + bbox.MaxX) / 2;
+        double mid_y = (bbox.MinY + bbox.MaxY) / 2;
+        ((quadrant & 1) ? bbox.MinX : bbox.MaxX) = mid_x;
+        ((quadrant & 2) ? bbox.MinY : bbox.MaxY) = mid_y;
+
+        nodes_.push_back({ bbox, { 0, 0, 0, 0 }, {} });
+        nodes_[parent].children[quadrant] = nodes_.size() - 1;
+    }
+    return nodes_[parent].children[quadrant];
+}
+
+/**
+ * Insert Polygon Piece
+ *
+ * Large pieces are split into quadrants, small ones are kept in the
+ * smallest cell holding all of them.
+ *
+ * \param[in] idx Node index
+ * \param[in] depth Node depth
+ * \param[in] geo Piece geometry (within node bounds)
+ */
+void land_index::insert(uint32_t idx, int depth, std::unique_ptr<OGRGeometry> geo)
+{
+    // Split large pieces into quadrants
+    std::unique_ptr<OGRGeometry> parts[4];
+    bool split = (depth < max_depth) && (count_points(geo.get()) > max_points);
+    for (int i = 0; split && (i < 4); i++)
+    {
+        OGRPolygon rect = rect_to_polygon(nodes_[get_child(idx, i)].bbox);
+        std::unique_ptr<OGRGeometry> part(geo->Intersection(&rect));
+        if (!part)
+        {
+            split = false;
+            break;
+        }
+
+        // Keep only polygons, not touching edges
+        auto polys = std::make_unique<OGRMultiPolygon>();
+        add_polygons(*polys, part.get());
+        if (polys->getNumGeometries() == 1)
+        {
+            parts[i].reset(polys->getGeometryRef(0)->clone());
+        }
+        else if (polys->getNumGeometries() > 1)
+        {
+            parts[i] = std::move(polys);
+        }
+    }
+    if (split)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            if (parts[i])
+            {
+                insert(nodes_[idx].children[i], depth + 1, std::move(parts[i]));
+            }
+        }
+        return;
+    }
+
+    // Otherwise keep in the smallest cell holding all of it, so queries
+    // elsewhere do not check it
+    piece next;
+    geo->getEnvelope(&next.bbox);
+    while (depth < max_depth)
+    {
+        // Quadrants are numbered by X (bit 0) and Y (bit 1) half
+        OGREnvelope cell = nodes_[idx].bbox;
+        double mid_x = (cell.MinX + cell.MaxX) / 2;
+        double mid_y = (cell.MinY + cell.MaxY) / 2;
+        int quadrant = 0;
+        if (next.bbox.MinX >= mid_x)
+        {
+            quadrant |= 1;
+        }
+        else if (next.bbox.MaxX > mid_x)
+        {
+            break;
+        }
+        if (next.bbox.MinY >= mid_y)
+        {
+            quadrant |= 2;
+        }
+        else if (next.bbox.MaxY > mid_y)
+        {
+            break;
+        }
+        idx = get_child(idx, quadrant);
+        depth++;
+    }
+    next.geo = std::move(geo);
+    pieces_.push_back(std::move(next));
+    nodes_[idx].pieces.push_back(pieces_.size() - 1);
+}
+
+}; // ~namespace encdata
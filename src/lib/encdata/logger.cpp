@@ -0,0 +1,259 @@
+/**
+ * \file
+ * \brief Asynchronous Logger
+ *
+ * Leveled, process wide logger. Request threads only format into a fixed
+ * size lock-free ring buffer, and a background thread writes lines out, so
+ * logging never waits on stdout. Lines are dropped (and counted) if the
+ * ring is full.
+ */
+
+#include <chrono>
+#include <cstdarg>
+#include <cstring>
+#include <ctime>
+#include <encdata/logger.h>
+
+namespace encdata
+{
+
+/// Writer polling interval, while idle
+static constexpr std::chrono::milliseconds idle_wait(10);
+
+/// Level names, by level
+static const char *const level_names[] = { "debug", "info", "warn", "error" };
+
+/**
+ * Get Process Logger
+ *
+ * \return Logger instance (writer started on first use)
+ */
+logger &logger::get()
+{
+    static logger instance;
+    return instance;
+}
+
+/**
+ * Constructor
+ */
+logger::logger()
+    : level_((int)log_level::INFO), head_(0), tail_(0), dropped_(0),
+      reported_(0), out_(stdout), stop_(false)
+{
+    for (std::size_t i = 0; i < slot_count; i++)
+    {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    writer_ = std::thread(&logger::run, this);
+}
+
+/**
+ * Destructor
+ *
+ * Writes out any queued lines, then stops writer thread.
+ */
+logger::~logger()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    writer_.join();
+}
+
+/**
+ * Set Minimum Level
+ *
+ * \param[in] level Least severe level written
+ */
+void logger::set_level(log_level level)
+{
+    level_.store((int)level, std::memory_order_relaxed);
+}
+
+/**
+ * Parse Level Name
+ *
+ * \param[in] name Level name (debug, info, warn or error)
+ * \param[out] level Parsed level
+ * \return False if name is not recognized
+ */
+bool logger::parse_level(const char *name, log_level &level)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        if (strcmp(name, level_names[i]) == 0)
+        {
+            level = (log_level)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Set Output Stream
+ *
+ * \param[in] out Output stream (default stdout, not closed)
+ */
+void logger::set_output(FILE *out)
+{
+    out_.store(out, std::memory_order_release);
+}
+
+/**
+ * Check Level Is Enabled
+ *
+ * \param[in] level Message level
+ * \return True if messages of this level are written
+ */
+bool logger::enabled(log_level level) const
+{
+    return (int)level >= level_.load(std::memory_order_relaxed);
+}
+
+/**
+ * Queue Message
+ *
+ * \param[in] level Message level
+ * \param[in] fmt Format string (printf style)
+ */
+void logger::write(log_level level, const char *fmt, ...)
+{
+    // Claim a free slot, or drop the line if the writer is behind
+    uint64_t pos = head_.load(std::memory_order_relaxed);
+    slot *next;
+    while (true)
+    {
+        next = &slots_[pos % slot_count];
+        uint64_t seq = next->sequence.load(std::memory_order_acquire);
+        if (seq == pos)
+        {
+            if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (seq < pos)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Fill in, then publish to writer
+    next->level = level;
+    next->time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(next->text, message_size, fmt, args);
+    va_end(args);
+    next->sequence.store(pos + 1, std::memory_order_release);
+}
+
+/**
+ * Wait for Queued Lines
+ *
+ * Returns once every line queued before the call has been written.
+ */
+void logger::flush()
+{
+    uint64_t target = head_.load(std::memory_order_acquire);
+    while (tail_.load(std::memory_order_acquire) < target)
+    {
+        wake_.notify_all();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+/**
+ * Get Dropped Line Count
+ *
+ * \return Lines dropped as ring buffer was full
+ */
+uint64_t logger::dropped() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+/**
+ * Writer Thread
+ */
+void logger::run()
+{
+    while (true)
+    {
+        if (drain())
+        {
+            continue;
+        }
+
+        // Nothing queued, so wait a bit (or until stopped)
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stop_)
+        {
+            break;
+        }
+        wake_.wait_for(lock, idle_wait);
+    }
+
+    // Anything queued while stopping
+    drain();
+}
+
+/**
+ * Write Out Queued Lines
+ *
+ * \return False if nothing was queued
+ */
+bool logger::drain()
+{
+    bool any = false;
+    FILE *out = out_.load(std::memory_order_acquire);
+    uint64_t pos = tail_.load(std::memory_order_relaxed);
+    while (true)
+    {
+        slot &next = slots_[pos % slot_count];
+        if (next.sequence.load(std::memory_order_acquire) != pos + 1)
+        {
+            break;
+        }
+
+        // Timestamp as UTC, with milliseconds
+        time_t secs = next.time / 1000000000;
+        struct tm utc;
+        gmtime_r(&secs, &utc);
+        char stamp[32];
+        strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &utc);
+        fprintf(out, "%s.%03dZ %-5s %s\n", stamp, (int)((next.time / 1000000) % 1000),
+                level_names[(int)next.level], next.text);
+
+        // Hand slot back to producers
+        next.sequence.store(pos + slot_count, std::memory_order_release);
+        tail_.store(++pos, std::memory_order_release);
+        any = true;
+    }
+
+    // Note any lines lost since last time
+    uint64_t total = dropped_.load(std::memory_order_relaxed);
+    uint64_t lost = total - reported_;
+    if (lost > 0)
+    {
+        fprintf(out, "(%lu log lines dropped)\n", (unsigned long)lost);
+        reported_ = total;
+    }
+    if (any || (lost > 0))
+    {
+        fflush(out);
+    }
+    return any;
+}
+
+}; // ~namespace encdata
@@ -0,0 +1,98 @@
+/**
+ * \file
+ * \brief Memory Mapped File
+ *
+ * Minimal RAII wrapper of a read-only memory mapped file.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <encdata/mapped_file.h>
+
+namespace encdata
+{
+
+/**
+ * Constructor
+ */
+mapped_file::mapped_file()
+    : data_(nullptr), size_(0)
+{
+}
+
+/**
+ * Destructor
+ */
+mapped_file::~mapped_file()
+{
+    close();
+}
+
+/**
+ * Map File
+ *
+ * \param[in] path Path to file
+ * \return False on failure (including empty files)
+ */
+bool mapped_file::open(const std::filesystem::path &path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // Mapping stays valid after the descriptor is closed
+    struct stat st = {};
+    if ((fstat(fd, &st) == 0) && (st.st_size > 0))
+    {
+        void *ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (ptr != MAP_FAILED)
+        {
+            data_ = static_cast<const uint8_t*>(ptr);
+            size_ = st.st_size;
+        }
+    }
+    ::close(fd);
+
+    return data_ != nullptr;
+}
+
+/**
+ * Unmap File
+ */
+void mapped_file::close()
+{
+    if (data_ != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+/**
+ * Get Mapped Data
+ *
+ * \return Start of mapping, or nullptr if not mapped
+ */
+const uint8_t *mapped_file::data() const
+{
+    return data_;
+}
+
+/**
+ * Get Mapped Size
+ *
+ * \return Size of mapping in bytes
+ */
+std::size_t mapped_file::size() const
+{
+    return size_;
+}
+
+}; // ~namespace encdata
@@ -0,0 +1,358 @@
+/**
+ * \file
+ * \brief ENC Metadata File
+ *
+ * Versioned binary file holding metadata for every indexed chart, memory
+ * mapped at startup so a warm start needs only a single open.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <encdata/metadata_file.h>
+
+namespace encdata
+{
+
+/// File identifier
+static const char file_magic[8] = { 'E', 'N', 'C', 'M', 'E', 'T', 'A', '\0' };
+
+/// File header (on disk)
+struct metadata_file::header
+{
+    /// File identifier
+    char magic[8];
+
+    /// File format version
+    uint32_t version;
+
+    /// Number of chart records (following header)
+    uint32_t count;
+
+    /// Offset to coverage bounds
+    uint64_t coverage_offset;
+
+    /// Number of coverage bounds
+    uint64_t coverage_count;
+
+    /// Offset to string data
+    uint64_t strings_offset;
+
+    /// Size of string data
+    uint64_t strings_size;
+};
+
+/// Per chart record (on disk)
+struct metadata_file::record
+{
+    /// Bounding box (MinX, MaxX, MinY, MaxY)
+    double bbox[4];
+
+    /// Compilation of scale (DSPM CSCL)
+    int32_t scale;
+
+    /// First coverage bounds
+    uint32_t coverage_first;
+
+    /// Number of coverage bounds
+    uint32_t coverage_count;
+
+    /// Length of chart path
+    uint32_t path_length;
+
+    /// Offset of chart path in string data
+    uint64_t path_offset;
+
+    /// Total size of chart and update files (bytes)
+    uint64_t file_size;
+
+    /// Latest modification time of chart and update files (ns)
+    int64_t file_time;
+
+    /// Edition number (DSID EDTN)
+    int32_t edition;
+
+    /// Update number (DSID UPDN)
+    int32_t update;
+
+    /// Length of simplified coverage polygon (WKB)
+    uint32_t wkb_length;
+
+    /// Version of chart store built from chart (0 if none)
+    uint32_t store_version;
+
+    /// Offset of simplified coverage polygon in string data
+    uint64_t wkb_offset;
+};
+
+/// Coverage bounds (on disk)
+struct metadata_file::bounds
+{
+    /// Bounding box (MinX, MaxX, MinY, MaxY)
+    double bbox[4];
+};
+
+/**
+ * Envelope to Array
+ *
+ * \param[out] out Output array
+ * \param[in] in Input envelope
+ */
+static void pack_envelope(double out[4], const OGREnvelope &in)
+{
+    out[0] = in.MinX;
+    out[1] = in.MaxX;
+    out[2] = in.MinY;
+    out[3] = in.MaxY;
+}
+
+/**
+ * Array to Envelope
+ *
+ * \param[in] in Input array
+ * \return Output envelope
+ */
+static OGREnvelope unpack_envelope(const double in[4])
+{
+    OGREnvelope out;
+    out.MinX = in[0];
+    out.MaxX = in[1];
+    out.MinY = in[2];
+    out.MaxY = in[3];
+    return out;
+}
+
+/**
+ * Constructor
+ */
+metadata_file::metadata_file()
+    : records_(nullptr), coverage_(nullptr), strings_(nullptr)
+{
+}
+
+/**
+ * Open Metadata File
+ *
+ * \param[in] path Path to metadata file
+ * \return False if missing, invalid, or wrong version
+ */
+bool metadata_file::open(const std::filesystem::path &path)
+{
+    close();
+    if (!file_.open(path) || (file_.size() < sizeof(header)))
+    {
+        close();
+        return false;
+    }
+
+    // Check header and section bounds
+    const uint8_t *base = file_.data();
+    const header *head = reinterpret_cast<const header*>(base);
+    uint64_t records_end = sizeof(header) + (uint64_t)head->count * sizeof(record);
+    if ((memcmp(head->magic, file_magic, sizeof(file_magic)) != 0) ||
+        (head->version != version) ||
+        (head->coverage_offset < records_end) ||
+        (head->coverage_offset % alignof(bounds) != 0) ||
+        (head->strings_offset < head->coverage_offset + head->coverage_count * sizeof(bounds)) ||
+        (head->strings_offset + head->strings_size != file_.size()))
+    {
+        close();
+        return false;
+    }
+    records_ = reinterpret_cast<const record*>(base + sizeof(header));
+    coverage_ = reinterpret_cast<const bounds*>(base + head->coverage_offset);
+    strings_ = base + head->strings_offset;
+    const char *strings = reinterpret_cast<const char*>(strings_);
+
+    // Index records by path, viewing strings in place
+    lookup_.reserve(head->count);
+    for (uint32_t i = 0; i < head->count; i++)
+    {
+        const record &rec = records_[i];
+        if ((rec.path_offset + rec.path_length > head->strings_size) ||
+            (rec.wkb_offset + rec.wkb_length > head->strings_size) ||
+            ((uint64_t)rec.coverage_first + rec.coverage_count > head->coverage_count))
+        {
+            close();
+            return false;
+        }
+        lookup_[std::string_view(strings + rec.path_offset, rec.path_length)] = i;
+    }
+
+    return true;
+}
+
+/**
+ * Close Metadata File
+ */
+void metadata_file::close()
+{
+    lookup_.clear();
+    records_ = nullptr;
+    coverage_ = nullptr;
+    strings_ = nullptr;
+    file_.close();
+}
+
+/**
+ * Get Chart Count
+ *
+ * \return Number of charts in file
+ */
+std::size_t metadata_file::size() const
+{
+    return lookup_.size();
+}
+
+/**
+ * Find Chart Record
+ *
+ * Record is viewed in place in the mapped file, nothing is copied.
+ *
+ * \param[in] path Path to ENC chart
+ * \return Chart record (valid until file is closed), or nullptr if not present
+ */
+const metadata_file::record *metadata_file::find(const std::filesystem::path &path) const
+{
+    auto it = lookup_.find(path.native());
+    if (it == lookup_.end())
+    {
+        return nullptr;
+    }
+    return &records_[it->second];
+}
+
+/**
+ * Check Record Fingerprint
+ *
+ * \param[in] rec Chart record
+ * \param[in] meta Chart metadata (with fingerprint set)
+ * \return True if record has the same file size and time
+ */
+bool metadata_file::matches(const record &rec, const chart_metadata &meta)
+{
+    return (rec.file_size == meta.file_size) && (rec.file_time == meta.file_time);
+}
+
+/**
+ * Get Recorded Chart Store Version
+ *
+ * \param[in] rec Chart record
+ * \return Version of chart store built from chart (0 if none)
+ */
+uint32_t metadata_file::store_version(const record &rec)
+{
+    return rec.store_version;
+}
+
+/**
+ * Copy Chart Metadata
+ *
+ * \param[in] rec Chart record
+ * \param[in,out] meta Chart metadata (path is kept)
+ */
+void metadata_file::copy(const record &rec, chart_metadata &meta) const
+{
+    meta.scale = rec.scale;
+    meta.bbox = unpack_envelope(rec.bbox);
+    meta.file_size = rec.file_size;
+    meta.file_time = rec.file_time;
+    meta.edition = rec.edition;
+    meta.update = rec.update;
+    meta.store_version = rec.store_version;
+    meta.coverage.resize(rec.coverage_count);
+    for (uint32_t i = 0; i < rec.coverage_count; i++)
+    {
+        meta.coverage[i] = unpack_envelope(coverage_[rec.coverage_first + i].bbox);
+    }
+    const unsigned char *wkb = strings_ + rec.wkb_offset;
+    meta.coverage_wkb.assign(wkb, wkb + rec.wkb_length);
+}
+
+/**
+ * Write Metadata File
+ *
+ * File is written to a temporary location, then atomically renamed into
+ * place, so readers always see either the old or new contents.
+ *
+ * \param[in] path Path to metadata file
+ * \param[in] charts Charts to save
+ * \return False on failure
+ */
+bool metadata_file::write(const std::filesystem::path &path,
+                          const std::vector<const chart_metadata*> &charts)
+{
+    // Build sections
+    std::vector<record> records;
+    std::vector<bounds> coverage;
+    std::string strings;
+    records.reserve(charts.size());
+    for (const chart_metadata *chart : charts)
+    {
+        record rec = {};
+        pack_envelope(rec.bbox, chart->bbox);
+        rec.scale = chart->scale;
+        rec.coverage_first = coverage.size();
+        rec.coverage_count = chart->coverage.size();
+        rec.path_offset = strings.size();
+        rec.path_length = chart->path.native().size();
+        rec.file_size = chart->file_size;
+        rec.file_time = chart->file_time;
+        rec.edition = chart->edition;
+        rec.update = chart->update;
+        rec.store_version = chart->store_version;
+        rec.wkb_offset = strings.size() + chart->path.native().size();
+        rec.wkb_length = chart->coverage_wkb.size();
+        records.push_back(rec);
+
+        for (const OGREnvelope &part : chart->coverage)
+        {
+            bounds next;
+            pack_envelope(next.bbox, part);
+            coverage.push_back(next);
+        }
+        strings += chart->path.native();
+        strings.append(chart->coverage_wkb.begin(), chart->coverage_wkb.end());
+    }
+
+    // Build header
+    header head = {};
+    memcpy(head.magic, file_magic, sizeof(file_magic));
+    head.version = version;
+    head.count = records.size();
+    head.coverage_offset = sizeof(header) + records.size() * sizeof(record);
+    head.coverage_count = coverage.size();
+    head.strings_offset = head.coverage_offset + coverage.size() * sizeof(bounds);
+    head.strings_size = strings.size();
+
+    // Write to temporary file, then swap into place
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp." + std::to_string(getpid());
+    FILE *handle = fopen(temp_path.c_str(), "wb");
+    if (handle == nullptr)
+    {
+        return false;
+    }
+    bool ok =
+        (fwrite(&head, sizeof(head), 1, handle) == 1) &&
+        (fwrite(records.data(), sizeof(record), records.size(), handle) == records.size()) &&
+        (fwrite(coverage.data(), sizeof(bounds), coverage.size(), handle) == coverage.size()) &&
+        (fwrite(strings.data(), 1, strings.size(), handle) == strings.size()) &&
+        (fflush(handle) == 0) &&
+        (fsync(fileno(handle)) == 0);
+    ok = (fclose(handle) == 0) && ok;
+
+    std::error_code ec;
+    if (ok)
+    {
+        std::filesystem::rename(temp_path, path, ec);
+        ok = !ec;
+    }
+    if (!ok)
+    {
+        std::filesystem::remove(temp_path, ec);
+    }
+    return ok;
+}
+
+}; // ~namespace encdata
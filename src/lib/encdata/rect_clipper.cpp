@@ -0,0 +1,428 @@
+/**
+ * \file
+ * \brief Rectangle Clipper
+ *
+ * Clips geometries to an axis aligned rectangle, using Liang-Barsky for
+ * lines and Sutherland-Hodgman for polygon rings. Much cheaper than a
+ * general (GEOS) intersection for tile shaped areas.
+ */
+
+#include <algorithm>
+#include <encdata/rect_clipper.h>
+
+namespace encdata
+{
+
+/// Coordinate, with optional elevation
+struct vertex
+{
+    double x, y, z;
+};
+
+/// Rectangle edges, in Sutherland-Hodgman clipping order
+enum rect_edge
+{
+    EDGE_MIN_X,
+    EDGE_MAX_X,
+    EDGE_MIN_Y,
+    EDGE_MAX_Y,
+};
+
+/**
+ * Get Curve Vertex
+ *
+ * \param[in] curve Input curve
+ * \param[in] idx Point index
+ * \return Vertex
+ */
+static vertex get_vertex(const OGRSimpleCurve &curve, int idx)
+{
+    return { curve.getX(idx), curve.getY(idx), curve.getZ(idx) };
+}
+
+/**
+ * Add Curve Vertex
+ *
+ * \param[out] curve Output curve
+ * \param[in] v Vertex
+ * \param[in] is_3d Include elevation
+ */
+static void add_vertex(OGRSimpleCurve &curve, const vertex &v, bool is_3d)
+{
+    if (is_3d)
+    {
+        curve.addPoint(v.x, v.y, v.z);
+    }
+    else
+    {
+        curve.addPoint(v.x, v.y);
+    }
+}
+
+/**
+ * Interpolate Between Vertices
+ *
+ * \param[in] a First vertex
+ * \param[in] b Second vertex
+ * \param[in] t Fraction of distance from a to b
+ * \return Interpolated vertex
+ */
+static vertex lerp(const vertex &a, const vertex &b, double t)
+{
+    return { a.x + t * (b.x - a.x), a.y + t * (b.y - a.y), a.z + t * (b.z - a.z) };
+}
+
+/**
+ * Clip Segment to Rectangle (Liang-Barsky)
+ *
+ * \param[in] a Segment start
+ * \param[in] b Segment end
+ * \param[in] rect Clipping rectangle
+ * \param[in,out] t0 Fraction of segment where clipped part starts
+ * \param[in,out] t1 Fraction of segment where clipped part ends
+ * \return False if segment is outside rectangle
+ */
+static bool clip_segment(const vertex &a, const vertex &b, const OGREnvelope &rect,
+                         double &t0, double &t1)
+{
+    double dx = b.x - a.x;
+    double dy = b.y - a.y;
+    const double p[4] = { -dx, dx, -dy, dy };
+    const double q[4] = { a.x - rect.MinX, rect.MaxX - a.x, a.y - rect.MinY, rect.MaxY - a.y };
+    for (int i = 0; i < 4; i++)
+    {
+        if (p[i] == 0)
+        {
+            // Parallel to this edge, and outside it
+            if (q[i] < 0)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        double t = q[i] / p[i];
+        if (p[i] < 0)
+        {
+            if (t > t1)
+            {
+                return false;
+            }
+            t0 = std::max(t0, t);
+        }
+        else
+        {
+            if (t < t0)
+            {
+                return false;
+            }
+            t1 = std::min(t1, t);
+        }
+    }
+    return true;
+}
+
+/**
+ * Check Vertex Inside Edge
+ *
+ * \param[in] v Vertex
+ * \param[in] edge Rectangle edge
+ * \param[in] rect Clipping rectangle
+ * \return True if on inner side of edge
+ */
+static bool inside_edge(const vertex &v, rect_edge edge, const OGREnvelope &rect)
+{
+    switch (edge)
+    {
+        case EDGE_MIN_X:
+            return v.x >= rect.MinX;
+        case EDGE_MAX_X:
+            return v.x <= rect.MaxX;
+        case EDGE_MIN_Y:
+            return v.y >= rect.MinY;
+        default:
+            return v.y <= rect.MaxY;
+    }
+}
+
+/**
+ * Intersect Segment With Edge
+ *
+ * Segment must cross the edge.
+ *
+ * \param[in] a Segment start
+ * \param[in] b Segment end
+ * \param[in] edge Rectangle edge
+ * \param[in] rect Clipping rectangle
+ * \return Crossing vertex, exactly on edge
+ */
+static vertex cross_edge(const vertex &a, const vertex &b, rect_edge edge,
+                         const OGREnvelope &rect)
+{
+    vertex v;
+    switch (edge)
+    {
+        case EDGE_MIN_X:
+            v = lerp(a, b, (rect.MinX - a.x) / (b.x - a.x));
+            v.x = rect.MinX;
+            break;
+        case EDGE_MAX_X:
+            v = lerp(a, b, (rect.MaxX - a.x) / (b.x - a.x));
+            v.x = rect.MaxX;
+            break;
+        case EDGE_MIN_Y:
+            v = lerp(a, b, (rect.MinY - a.y) / (b.y - a.y));
+            v.y = rect.MinY;
+            break;
+        default:
+            v = lerp(a, b, (rect.MaxY - a.y) / (b.y - a.y));
+            v.y = rect.MaxY;
+            break;
+    }
+    return v;
+}
+
+/**
+ * Constructor
+ *
+ * \param[in] rect Clipping rectangle
+ */
+rect_clipper::rect_clipper(const OGREnvelope &rect)
+    : rect_(rect)
+{
+}
+
+/**
+ * Clip Geometry
+ *
+ * Polygons clipped against a concave boundary may keep zero area
+ * connecting edges along the rectangle boundary. Curved geometry (not
+ * present in S57) is not supported.
+ *
+ * \param[in] geo Input geometry
+ * \return Clipped geometry, or nullptr if outside rectangle
+ */
+std::unique_ptr<OGRGeometry> rect_clipper::clip(const OGRGeometry &geo) const
+{
+    // Trivial cases
+    OGREnvelope env;
+    geo.getEnvelope(&env);
+    if (geo.IsEmpty() || !rect_.Intersects(env))
+    {
+        return nullptr;
+    }
+    if (rect_.Contains(env))
+    {
+        return std::unique_ptr<OGRGeometry>(geo.clone());
+    }
+
+    OGRwkbGeometryType type = wkbFlatten(geo.getGeometryType());
+    switch (type)
+    {
+        case wkbPoint:
+            // Point within bounding box, but not rectangle?
+            return nullptr;
+
+        case wkbLineString:
+        {
+            std::vector<std::unique_ptr<OGRLineString>> pieces;
+            clip_line(pieces, *geo.toLineString());
+            if (pieces.empty())
+            {
+                return nullptr;
+            }
+            if (pieces.size() == 1)
+            {
+                return std::move(pieces.front());
+            }
+            auto out = std::make_unique<OGRMultiLineString>();
+            for (auto &piece : pieces)
+            {
+                out->addGeometryDirectly(piece.release());
+            }
+            return out;
+        }
+
+        case wkbPolygon:
+            return clip_polygon(*geo.toPolygon());
+
+        case wkbMultiPoint:
+        case wkbMultiLineString:
+        case wkbMultiPolygon:
+        case wkbGeometryCollection:
+        {
+            // Same kind of collection, of clipped parts
+            std::unique_ptr<OGRGeometry> out(OGRGeometryFactory::createGeometry(type));
+            OGRGeometryCollection *coll = out->toGeometryCollection();
+            const OGRGeometryCollection *in = geo.toGeometryCollection();
+            for (int i = 0; i < in->getNumGeometries(); i++)
+            {
+                const OGRGeometry *part = in->getGeometryRef(i);
+                if (wkbFlatten(part->getGeometryType()) == wkbLineString)
+                {
+                    // Lines may be split into several pieces
+                    std::vector<std::unique_ptr<OGRLineString>> pieces;
+                    clip_line(pieces, *part->toLineString());
+                    for (auto &piece : pieces)
+                    {
+                        coll->addGeometryDirectly(piece.release());
+                    }
+                }
+                else if (std::unique_ptr<OGRGeometry> clipped = clip(*part))
+                {
+                    coll->addGeometryDirectly(clipped.release());
+                }
+            }
+            if (coll->IsEmpty())
+            {
+                return nullptr;
+            }
+            return out;
+        }
+
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * Clip Line
+ *
+ * \param[out] out Clipped pieces (appended)
+ * \param[in] line Input line
+ */
+void rect_clipper::clip_line(std::vector<std::unique_ptr<OGRLineString>> &out,
+                             const OGRSimpleCurve &line) const
+{
+    bool is_3d = line.Is3D();
+    std::unique_ptr<OGRLineString> piece;
+    for (int i = 0; i + 1 < line.getNumPoints(); i++)
+    {
+        vertex a = get_vertex(line, i);
+        vertex b = get_vertex(line, i + 1);
+        double t0 = 0;
+        double t1 = 1;
+        if (!clip_segment(a, b, rect_, t0, t1))
+        {
+            if (piece)
+            {
+                out.push_back(std::move(piece));
+            }
+            continue;
+        }
+
+        // Extend current piece, starting a new one on entry
+        if (!piece)
+        {
+            piece = std::make_unique<OGRLineString>();
+            add_vertex(*piece, lerp(a, b, t0), is_3d);
+        }
+        add_vertex(*piece, lerp(a, b, t1), is_3d);
+
+        // Piece ends where segment leaves rectangle
+        if (t1 < 1)
+        {
+            out.push_back(std::move(piece));
+        }
+    }
+    if (piece)
+    {
+        out.push_back(std::move(piece));
+    }
+}
+
+/**
+ * Clip Polygon Ring
+ *
+ * \param[in] ring Input ring
+ * \return Clipped ring, or nullptr if outside rectangle
+ */
+std::unique_ptr<OGRLinearRing> rect_clipper::clip_ring(const OGRSimpleCurve &ring) const
+{
+    // Open ring (drop closing point)
+    std::vector<vertex> poly, next;
+    for (int i = 0; i < ring.getNumPoints(); i++)
+    {
+        poly.push_back(get_vertex(ring, i));
+    }
+    if ((poly.size() > 1) && (poly.front().x == poly.back().x) &&
+        (poly.front().y == poly.back().y))
+    {
+        poly.pop_back();
+    }
+
+    // Clip against each edge in turn (Sutherland-Hodgman)
+    for (rect_edge edge : { EDGE_MIN_X, EDGE_MAX_X, EDGE_MIN_Y, EDGE_MAX_Y })
+    {
+        if (poly.empty())
+        {
+            break;
+        }
+        next.clear();
+        vertex prev = poly.back();
+        bool prev_in = inside_edge(prev, edge, rect_);
+        for (const vertex &v : poly)
+        {
+            bool in = inside_edge(v, edge, rect_);
+            if (in != prev_in)
+            {
+                next.push_back(cross_edge(prev, v, edge, rect_));
+            }
+            if (in)
+            {
+                next.push_back(v);
+            }
+            prev = v;
+            prev_in = in;
+        }
+        poly.swap(next);
+    }
+    if (poly.size() < 3)
+    {
+        return nullptr;
+    }
+
+    // Close ring again
+    bool is_3d = ring.Is3D();
+    auto out = std::make_unique<OGRLinearRing>();
+    for (const vertex &v : poly)
+    {
+        add_vertex(*out, v, is_3d);
+    }
+    add_vertex(*out, poly.front(), is_3d);
+    return out;
+}
+
+/**
+ * Clip Polygon
+ *
+ * \param[in] poly Input polygon
+ * \return Clipped polygon, or nullptr if outside rectangle
+ */
+std::unique_ptr<OGRPolygon> rect_clipper::clip_polygon(const OGRPolygon &poly) const
+{
+    const OGRLinearRing *outer = poly.getExteriorRing();
+    if (outer == nullptr)
+    {
+        return nullptr;
+    }
+    std::unique_ptr<OGRLinearRing> ring = clip_ring(*outer);
+    if (!ring)
+    {
+        return nullptr;
+    }
+
+    auto out = std::make_unique<OGRPolygon>();
+    out->addRingDirectly(ring.release());
+    for (int i = 0; i < poly.getNumInteriorRings(); i++)
+    {
+        ring = clip_ring(*poly.getInteriorRing(i));
+        if (ring)
+        {
+            out->addRingDirectly(ring.release());
+        }
+    }
+    return out;
+}
+
+}; // ~namespace encdata
@@ -0,0 +1,191 @@
+/**
+ * \file
+ * \brief Color Palette
+ *
+ * Indexed color table (up to 256 entries) for 8 bit tile output. Charts are
+ * drawn without antialiasing from a closed set of theme colors, so rendered
+ * pixels almost always match an entry exactly.
+ */
+
+#include <encviz/color_palette.h>
+
+namespace encviz
+{
+
+/**
+ * Premultiply Color
+ *
+ * Rounds as cairo does for solid sources, so drawn pixels match exactly.
+ *
+ * \param[in] c Straight ARGB color
+ * \return Premultiplied ARGB32 pixel
+ */
+static uint32_t premultiply(const color &c)
+{
+    auto channel = [&](uint8_t v) -> uint32_t {
+        return (uint32_t)((v / 255.0) * (c.alpha / 255.0) * 65535.0 + 0.5) >> 8;
+    };
+    return ((uint32_t)c.alpha << 24) | (channel(c.red) << 16) |
+        (channel(c.green) << 8) | channel(c.blue);
+}
+
+/**
+ * Constructor
+ *
+ * Palette starts with fully transparent as index zero.
+ */
+color_palette::color_palette()
+{
+    add(color());
+}
+
+/**
+ * Add Color
+ *
+ * \param[in] c Straight ARGB color
+ * \return False if palette is full (color not added)
+ */
+bool color_palette::add(const color &c)
+{
+    uint32_t pixel = premultiply(c);
+    if (lookup_.count(pixel))
+    {
+        // Already present
+        return true;
+    }
+    if (entries_.size() >= max_size)
+    {
+        return false;
+    }
+    lookup_[pixel] = entries_.size();
+    entries_.push_back(c);
+    pixels_.push_back(pixel);
+    return true;
+}
+
+/**
+ * Get Number of Entries
+ *
+ * \return Palette size
+ */
+std::size_t color_palette::size() const
+{
+    return entries_.size();
+}
+
+/**
+ * Get Palette Entries
+ *
+ * \return Straight ARGB colors, by index
+ */
+const std::vector<color> &color_palette::entries() const
+{
+    return entries_;
+}
+
+/**
+ * Map Pixels to Palette
+ *
+ * \param[out] indexes Palette indexes (replaced, one per pixel)
+ * \param[in] pixels Premultiplied ARGB32 pixels (cairo)
+ * \param[in] count Number of pixels
+ */
+void color_palette::quantize(std::vector<uint8_t> &indexes, const uint32_t *pixels,
+                             std::size_t count) const
+{
+    indexes.resize(count);
+
+    // Tiles are mostly long runs, so remember the last pixel looked up
+    uint32_t last_pixel = 0;
+    uint8_t last_index = lookup_.find(0)->second;
+    std::unordered_map<uint32_t, uint8_t> misses;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (pixels[i] != last_pixel)
+        {
+            last_pixel = pixels[i];
+            auto it = lookup_.find(last_pixel);
+            if (it != lookup_.end())
+            {
+                last_index = it->second;
+            }
+            else
+            {
+                auto miss = misses.find(last_pixel);
+                if (miss == misses.end())
+                {
+                    miss = misses.emplace(last_pixel, nearest(last_pixel)).first;
+                }
+                last_index = miss->second;
+            }
+        }
+        indexes[i] = last_index;
+    }
+}
+
+/**
+ * Find Nearest Entry
+ *
+ * \param[in] pixel Premultiplied ARGB32 pixel
+ * \return Palette index
+ */
+uint8_t color_palette::nearest(uint32_t pixel) const
+{
+    std::size_t best = 0;
+    int best_dist = -1;
+    for (std::size_t i = 0; i < pixels_.size(); i++)
+    {
+        int dist = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            int d = (int)((pixel >> shift) & 0xff) - (int)((pixels_[i] >> shift) & 0xff);
+            dist += d * d;
+        }
+        if ((best_dist < 0) || (dist < best_dist))
+        {
+            best = i;
+            best_dist = dist;
+        }
+    }
+    return best;
+}
+
+/**
+ * Build Palette for Style
+ *
+ * \param[in] style Render style
+ * \param[in] theme Color theme of style
+ * \return Palette (colors past the limit are dropped)
+ */
+color_palette build_palette(const render_style &style, const color_theme &theme)
+{
+    color_palette palette;
+    auto add_style = [&](const simple_style &s) {
+        palette.add(s.fill_color);
+        palette.add(s.line_color);
+        palette.add(s.text_color);
+    };
+
+    // Colors actually drawn by the style come first
+    if (style.background.has_value())
+    {
+        palette.add(style.background.value());
+    }
+    for (const layer_style &lstyle : style.layers)
+    {
+        add_style(lstyle.style);
+        for (const simple_style &s : lstyle.cutoff_styles)
+        {
+            add_style(s);
+        }
+    }
+
+    // Then the rest of the theme
+    for (const auto &it : theme)
+    {
+        palette.add(it.second);
+    }
+    return palette;
+}
+
+}; // ~namespace encviz
@@ -5,6 +5,7 @@
  * C++ abstraction class to handle visualization of ENC(S-57) chart data.
  */
 
+#include <algorithm>
 #include <encviz/enc_renderer.h>
 #include <encviz/xml_config.h>
 namespace fs = std::filesystem;
@@ -12,27 +13,6 @@ namespace fs = std::filesystem;
 namespace encviz
 {
 
-/**
- * Cairo Stream Callback
- *
- * \param[out] closure Pointer to std::vector<uint8_t> output stream
- * \param[in] data Data buffer
- * \param[in] length Length of data buffer
- */
-static cairo_status_t cairo_write_to_vector(void *closure,
-                                            const unsigned char *data,
-                                            unsigned int length)
-{
-    // TODO - Can probably make this better
-    std::vector<uint8_t> *output = (std::vector<uint8_t>*)closure;
-    output->reserve(output->size() + length);
-    for (unsigned int i = 0; i < length; i++)
-    {
-        output->push_back(data[i]);
-    }
-    return CAIRO_STATUS_SUCCESS;
-}
-
 /**
  * Constructor
  *
@@ -58,62 +38,154 @@ enc_renderer::enc_renderer(const char *config_path)
 /**
  * Render Chart Data
  *
- * \param[out] data PNG bytestream
+ * \param[out] data Encoded image bytestream (in configured tile format)
  * \param[in] tc Tile coordinate system (WMTS or XYZ)
  * \param[in] x Tile X coordinate (horizontal)
  * \param[in] y Tile Y coordinate (vertical)
  * \param[in] z Tile Z coordinate (zoom)
  * \param[in] style Tile styling data
+ * \param[out] stats Data export statistics (nullptr to skip)
  * \return False if no data to render
  */
 bool enc_renderer::render(std::vector<uint8_t> &data, tile_coords tc,
-                          int x, int y, int z, const char *style_name)
+                          int x, int y, int z, const char *style_name,
+                          encdata::export_stats *stats)
 {
-    // Grab the style we need
-    if (styles_.find(style_name) == styles_.end())
+    return render(data, format_, tc, x, y, z, style_name, stats);
+}
+
+/**
+ * Render Chart Data in Format
+ *
+ * \param[out] data Encoded image bytestream
+ * \param[in] format Tile format (see supports_format())
+ * \param[in] tc Tile coordinate system (WMTS or XYZ)
+ * \param[in] x Tile X coordinate (horizontal)
+ * \param[in] y Tile Y coordinate (vertical)
+ * \param[in] z Tile Z coordinate (zoom)
+ * \param[in] style Tile styling data
+ * \param[out] stats Data export statistics (nullptr to skip)
+ * \return False if no data to render
+ */
+bool enc_renderer::render(std::vector<uint8_t> &data, tile_format format, tile_coords tc,
+                          int x, int y, int z, const char *style_name,
+                          encdata::export_stats *stats)
+{
+    if (!supports_format(format))
+    {
+        throw std::runtime_error("Unsupported tile format");
+    }
+
+    // Draw into this thread's pixel buffer
+    thread_local std::vector<uint32_t> pixels;
+    if (!render_pixels(pixels, tc, x, y, z, style_name, stats))
     {
         return false;
     }
-    const render_style &style = styles_[style_name];
 
-    // Collect the layers we need
-    std::vector<std::string> layers;
-    for (const layer_style &lstyle : style.layers)
+    // Single color tiles (open water, land, no data) are only encoded once,
+    // and shared by all requests
+    uint32_t flat;
+    bool uniform = uniform_tiles::is_uniform(pixels.data(), pixels.size(), flat);
+    if (uniform && uniform_.find(data, (int)format, flat))
     {
-        layers.push_back(lstyle.layer_name);
+        return true;
     }
 
-    // Get base tile boundaries
-    encviz::web_mercator wm(x, y, z, tc, tile_size_);
-    OGREnvelope bbox = wm.get_bbox_deg();
+    // Write out image (palette tiles need pixels mapped to indexes)
+    bool encoded;
+    if (format == tile_format::PNG8)
+    {
+        // Single color tiles don't need the whole style palette
+        color_palette flat_palette;
+        if (uniform)
+        {
+            color c;
+            c.alpha = flat >> 24;
+            if (c.alpha != 0)
+            {
+                c.red = (((flat >> 16) & 0xff) * 255 + c.alpha / 2) / c.alpha;
+                c.green = (((flat >> 8) & 0xff) * 255 + c.alpha / 2) / c.alpha;
+                c.blue = ((flat & 0xff) * 255 + c.alpha / 2) / c.alpha;
+            }
+            flat_palette.add(c);
+        }
+        const color_palette &palette =
+            uniform ? flat_palette : palettes_.find(style_name)->second;
 
-    // Oversample a bit so not clip text between tiles
+        thread_local std::vector<uint8_t> indexes;
+        palette.quantize(indexes, pixels.data(), pixels.size());
+        encoded = png_.encode_indexed(data, indexes.data(), tile_size_, tile_size_, palette);
+    }
+    else if (format == tile_format::WEBP)
     {
-        double oversample = 0.1;
-        double width = bbox.MaxX - bbox.MinX;
-        double height = bbox.MaxY - bbox.MinY;
-        bbox.MinX -= oversample * (width/2);
-        bbox.MaxX += oversample * (width/2);
-        bbox.MinY -= oversample * (height/2);
-        bbox.MaxY += oversample * (height/2);
+        encoded = webp_.encode(data, pixels.data(), tile_size_, tile_size_);
     }
+    else
+    {
+        encoded = png_.encode(data, pixels.data(), tile_size_, tile_size_);
+    }
+    if (!encoded)
+    {
+        throw std::runtime_error("Cannot encode tile");
+    }
+    if (uniform)
+    {
+        uniform_.insert(data, (int)format, flat);
+    }
+    return true;
+}
+
+/**
+ * Render Chart Data to Pixels
+ *
+ * \param[out] pixels Premultiplied ARGB32 pixels, by row (tile size squared)
+ * \param[in] tc Tile coordinate system (WMTS or XYZ)
+ * \param[in] x Tile X coordinate (horizontal)
+ * \param[in] y Tile Y coordinate (vertical)
+ * \param[in] z Tile Z coordinate (zoom)
+ * \param[in] style Tile styling data
+ * \param[out] stats Data export statistics (nullptr to skip)
+ * \return False if no data to render
+ */
+bool enc_renderer::render_pixels(std::vector<uint32_t> &pixels, tile_coords tc,
+                                 int x, int y, int z, const char *style_name,
+                                 encdata::export_stats *stats)
+{
+    // Grab the style we need (styles are only read once loaded), and the
+    // layers and attributes it uses
+    auto it = styles_.find(style_name);
+    if (it == styles_.end())
+    {
+        return false;
+    }
+    const render_style &style = it->second;
+    const std::vector<encdata::enc_dataset::layer_spec> &layers =
+        style_layers_.find(style_name)->second;
+
+    // Get base tile boundaries (each layer is exported with its own margin,
+    // so text and markers are not clipped between tiles)
+    encviz::web_mercator wm(x, y, z, tc, tile_size_);
+    OGREnvelope bbox = wm.get_bbox_deg();
 
     // Compute minimum presentation scale, based on average latitude and zoom
     // TODO - Is this the right computation?
     double avgLat = (bbox.MinY + bbox.MaxY) / 2;
     int scale_min = (int)round(min_scale0_ * cos(avgLat * M_PI / 180) / pow(2, z));
 
-    // Export all data in this tile
-    GDALDataset *tile_data = GetGDALDriverManager()->GetDriverByName(GDAL_MEM_DRIVER)->
-        Create("", 0, 0, 0, GDT_Unknown, nullptr);
-    if (!enc_.export_data(tile_data, layers, bbox, scale_min))
+    // Export all data in this tile, reusing this thread's feature storage
+    thread_local encdata::feature_set tile_data;
+    if (!enc_.export_data(tile_data, layers, bbox, scale_min, stats))
     {
         return false;
     }
 
-    // Create a cairo surface
+    // Create a cairo surface over the (cleared) pixel buffer
+    pixels.assign((std::size_t)tile_size_ * tile_size_, 0);
     cairo_surface_t *surface =
-        cairo_image_surface_create(CAIRO_FORMAT_ARGB32, tile_size_, tile_size_);
+        cairo_image_surface_create_for_data((unsigned char*)pixels.data(),
+                                            CAIRO_FORMAT_ARGB32, tile_size_, tile_size_,
+                                            tile_size_ * sizeof(uint32_t));
     cairo_t *cr = cairo_create(surface);
     cairo_set_antialias(cr, CAIRO_ANTIALIAS_NONE);
 
@@ -127,107 +199,158 @@ bool enc_renderer::render(std::vector<uint8_t> &data, tile_coords tc,
     // Render style layers
     for (const auto &lstyle : style.layers)
     {
-        // Render feature geometry in this layer
-        OGRLayer *tile_layer = tile_data->GetLayerByName(lstyle.layer_name.c_str());
-        for (const auto &feat : tile_layer)
+        const encdata::feature_set::layer *tile_layer =
+            tile_data.find_layer(lstyle.layer_name);
+        if (tile_layer == nullptr)
         {
-            OGRGeometry *geo = feat->GetGeometryRef();
-            const simple_style &geo_style = get_feat_style(feat, lstyle);
-            render_geo(cr, geo, wm, geo_style);
+            continue;
         }
-    }
 
-    // Write out image
-    data.clear();
-    cairo_status_t rc =
-        cairo_surface_write_to_png_stream(surface,
-                                          cairo_write_to_vector,
-                                          &data);
-    if (rc)
-    {
-        printf("Cairo write error %d : %s\n", rc,
-               cairo_status_to_string(rc));
+        // Convert all lat/lon in this layer to pixel coordinates at once
+        thread_local std::vector<double> px, py;
+        px.resize(tile_layer->x.size());
+        py.resize(tile_layer->y.size());
+        wm.deg_to_pixels(tile_layer->x.data(), tile_layer->y.data(), tile_layer->x.size(),
+                         px.data(), py.data());
+
+        // Render feature geometry in this layer
+        int cutoff_attr = tile_layer->find_attr(lstyle.cutoff_attr.c_str());
+        for (std::size_t i = 0; i < tile_layer->size(); i++)
+        {
+            const simple_style &geo_style =
+                get_feat_style(*tile_layer, i, cutoff_attr, lstyle);
+            render_feature(cr, *tile_layer, i, px.data(), py.data(), geo_style);
+        }
     }
 
-    // Cleanup
+    // Cleanup (pixels are left in buffer)
     cairo_destroy(cr);
+    cairo_surface_flush(surface);
     cairo_surface_destroy(surface);
-    GDALClose(tile_data);
 
     return true;
 }
 
 /**
- * Render Feature Geometry
+ * Get Tile Size
  *
- * \param[out] cr Image context
- * \param[in] geo Feature geometry
- * \param[in] wm Web Mercator point mapper
- * \param[in] style Feature style
+ * \return Dimension of output image
  */
-void enc_renderer::render_geo(cairo_t *cr, const OGRGeometry *geo,
-                              const web_mercator &wm, const simple_style &style)
+int enc_renderer::get_tile_size() const
 {
-    // What sort of geometry were we passed?
-    OGRwkbGeometryType gtype = geo->getGeometryType();
-    switch (gtype)
-    {
-        case wkbPoint: // 1
-            render_point(cr, geo->toPoint(), wm, style);
-            break;
-
-        case wkbMultiPoint: // 4
-            for (const OGRPoint *child : geo->toMultiPoint())
-            {
-                render_point(cr, child, wm, style);
-            }
-            break;
+    return tile_size_;
+}
 
-        case wkbPoint25D: // 0x80000001
-            // TODO - SOUNDG only?
-            render_depth(cr, geo->toPoint(), wm, style);
-            break;
+/**
+ * Get Configured Tile Format
+ *
+ * \return Format used by render() unless another is requested
+ */
+tile_format enc_renderer::get_tile_format() const
+{
+    return format_;
+}
 
-        case wkbMultiPoint25D: // 0x80000004
-            // TODO - SOUNDG only?
-            for (const OGRPoint *child : geo->toMultiPoint())
-            {
-                render_depth(cr, child, wm, style);
-            }
-            break;
+/**
+ * Check Tile Format Support
+ *
+ * \param[in] format Tile format
+ * \return False if format cannot be encoded (ie - built without libwebp)
+ */
+bool enc_renderer::supports_format(tile_format format)
+{
+    return (format != tile_format::WEBP) || webp_encoder::available();
+}
 
-        case wkbLineString: // 2
-            render_line(cr, geo->toLineString(), wm, style);
-            break;
+/**
+ * Get PNG Encoder
+ *
+ * \return Configured PNG encoder
+ */
+const png_encoder &enc_renderer::get_png_encoder() const
+{
+    return png_;
+}
 
-        case wkbMultiLineString: // 5
-            for (const OGRGeometry *child : geo->toMultiLineString())
-            {
-                render_geo(cr, child, wm, style);
-            }
-            break;
+/**
+ * Get Style Palette
+ *
+ * \param[in] style_name Name of style
+ * \return Palette of style colors (nullptr if no such style)
+ */
+const color_palette *enc_renderer::get_palette(const char *style_name) const
+{
+    auto it = palettes_.find(style_name);
+    return (it == palettes_.end()) ? nullptr : &it->second;
+}
 
-        case wkbPolygon: // 6
-            render_poly(cr, geo->toPolygon(), wm, style);
-            break;
+/**
+ * Get WebP Encoder
+ *
+ * \return Configured WebP encoder
+ */
+const webp_encoder &enc_renderer::get_webp_encoder() const
+{
+    return webp_;
+}
 
-        case wkbMultiPolygon: // 10
-            for (const OGRPolygon *child : geo->toMultiPolygon())
+/**
+ * Render Feature Geometry
+ *
+ * \param[out] cr Image context
+ * \param[in] layer Feature layer
+ * \param[in] idx Feature index
+ * \param[in] px Layer point columns (pixels)
+ * \param[in] py Layer point rows (pixels)
+ * \param[in] style Feature style
+ */
+void enc_renderer::render_feature(cairo_t *cr, const encdata::feature_set::layer &layer,
+                                  std::size_t idx, const double *px, const double *py,
+                                  const simple_style &style)
+{
+    const encdata::feature_set::feature &feat = layer.features[idx];
+    std::size_t part_end = feat.part_first + feat.part_count;
+    for (std::size_t i = feat.part_first; i < part_end; i++)
+    {
+        const encdata::feature_set::part &part = layer.parts[i];
+        switch (part.kind)
+        {
+            case encdata::POINT:
             {
-                render_poly(cr, child, wm, style);
+                coord c = { px[part.first], py[part.first] };
+                if (feat.is_3d)
+                {
+                    // TODO - SOUNDG only?
+                    render_depth(cr, c, layer.z[part.first], style);
+                }
+                else
+                {
+                    render_point(cr, c, style);
+                }
+                break;
             }
-            break;
 
-        case wkbGeometryCollection: // 7
-            for (const OGRGeometry *child : geo->toGeometryCollection())
+            case encdata::LINE:
+                render_line(cr, layer, part, px, py, style);
+                break;
+
+            case encdata::OUTER_RING:
             {
-                render_geo(cr, child, wm, style);
+                // Interior rings follow their exterior ring
+                std::size_t ring_end = i + 1;
+                while ((ring_end < part_end) &&
+                       (layer.parts[ring_end].kind == encdata::INNER_RING))
+                {
+                    ring_end++;
+                }
+                render_poly(cr, layer, i, ring_end, px, py, style, feat.outline);
+                i = ring_end - 1;
+                break;
             }
-            break;
 
-        default:
-            throw std::runtime_error("Unhandled geometry of type " +
-                                     std::to_string(gtype));
+            default:
+                throw std::runtime_error("Unexpected interior ring");
+        }
     }
 }
 
@@ -235,19 +358,16 @@ void enc_renderer::render_geo(cairo_t *cr, const OGRGeometry *geo,
  * Render Depth Value
  *
  * \param[out] cr Image context
- * \param[in] geo Feature geometry
- * \param[in] wm Web Mercator point mapper
+ * \param[in] c Point location (pixels)
+ * \param[in] depth Depth value
  * \param[in] style Feature style
  */
-void enc_renderer::render_depth(cairo_t *cr, const OGRPoint *geo,
-                                const web_mercator &wm, const simple_style &style)
+void enc_renderer::render_depth(cairo_t *cr, const coord &c, double depth,
+                                const simple_style &style)
 {
-    // Convert lat/lon to pixel coordinates
-    coord c = wm.point_to_pixels(*geo);
-
     // TODO - Could do this better?
     char text[64] = {};
-    snprintf(text, sizeof(text)-1, "%.1f", geo->getZ());
+    snprintf(text, sizeof(text)-1, "%.1f", depth);
 
     // Select font
     set_color(cr, style.text_color);
@@ -269,12 +389,10 @@ void enc_renderer::render_depth(cairo_t *cr, const OGRPoint *geo,
  * Render Point Geometry
  *
  * \param[out] cr Image context
- * \param[in] geo Feature geometry
- * \param[in] wm Web Mercator point mapper
+ * \param[in] c Point location (pixels)
  * \param[in] style Feature style
  */
-void enc_renderer::render_point(cairo_t *cr, const OGRPoint *geo,
-                                const web_mercator &wm, const simple_style &style)
+void enc_renderer::render_point(cairo_t *cr, const coord &c, const simple_style &style)
 {
     // Skip render if not appropriate
     if (style.marker_size == 0)
@@ -282,9 +400,6 @@ void enc_renderer::render_point(cairo_t *cr, const OGRPoint *geo,
         return;
     }
 
-    // Convert lat/lon to pixel coordinates
-    coord c = wm.point_to_pixels(*geo);
-
     // Draw circle
     cairo_arc(cr, c.x, c.y, style.marker_size, 0, 2 * M_PI);
 
@@ -300,31 +415,18 @@ void enc_renderer::render_point(cairo_t *cr, const OGRPoint *geo,
  * Render LineString Geometry
  *
  * \param[out] cr Image context
- * \param[in] geo Feature geometry
- * \param[in] wm Web Mercator point mapper
+ * \param[in] layer Feature layer
+ * \param[in] part Line geometry part
+ * \param[in] px Layer point columns (pixels)
+ * \param[in] py Layer point rows (pixels)
  * \param[in] style Feature style
  */
-void enc_renderer::render_line(cairo_t *cr, const OGRLineString *geo,
-                               const web_mercator &wm, const simple_style &style)
+void enc_renderer::render_line(cairo_t *cr, const encdata::feature_set::layer &layer,
+                               const encdata::feature_set::part &part,
+                               const double *px, const double *py,
+                               const simple_style &style)
 {
-    // Pass OGR points to cairo
-    bool first = true;
-    for (auto &point : geo)
-    {
-        // Convert lat/lon to pixel coordinates
-        coord c = wm.point_to_pixels(point);
-
-        // Mark first point as pen-down
-        if (first)
-        {
-            cairo_move_to(cr, c.x, c.y);
-            first = false;
-        }
-        else
-        {
-            cairo_line_to(cr, c.x, c.y);
-        }
-    }
+    trace_part(cr, layer, part, px, py);
 
     // Draw line
     set_color(cr, style.line_color);
@@ -336,82 +438,84 @@ void enc_renderer::render_line(cairo_t *cr, const OGRLineString *geo,
  * Render Polygon Geometry
  *
  * \param[out] cr Image context
- * \param[in] geo Feature geometry
- * \param[in] wm Web Mercator point mapper
+ * \param[in] layer Feature layer
+ * \param[in] ring_first Exterior ring part index
+ * \param[in] ring_end Index past last interior ring part
+ * \param[in] px Layer point columns (pixels)
+ * \param[in] py Layer point rows (pixels)
  * \param[in] style Feature style
+ * \param[in] outline Draw outline as well as fill
  */
-void enc_renderer::render_poly(cairo_t *cr, const OGRPolygon *geo,
-                               const web_mercator &wm, const simple_style &style)
+void enc_renderer::render_poly(cairo_t *cr, const encdata::feature_set::layer &layer,
+                               std::size_t ring_first, std::size_t ring_end,
+                               const double *px, const double *py,
+                               const simple_style &style, bool outline)
 {
-    // Pass OGR points to cairo
-    bool first = true;
-    for (auto &point : geo->getExteriorRing())
+    // Each ring is its own sub path
+    for (std::size_t i = ring_first; i < ring_end; i++)
     {
-        // Convert lat/lon to pixel coordinates
-        coord c = wm.point_to_pixels(point);
-
-        // Mark first point as pen-down
-        if (first)
-        {
-            cairo_move_to(cr, c.x, c.y);
-            first = false;
-        }
-        else
-        {
-            cairo_line_to(cr, c.x, c.y);
-        }
+        cairo_new_sub_path(cr);
+        trace_part(cr, layer, layer.parts[i], px, py);
     }
 
-    int int_ring_count = geo->getNumInteriorRings();
-    for (int i = 0; i < int_ring_count; i++)
+    // Draw fill, and line unless split from a larger polygon
+    set_color(cr, style.fill_color);
+    if (!outline)
     {
-        cairo_new_sub_path (cr);
-
-        first = true;
-        for (auto &point : geo->getInteriorRing(i))
-        {
-            // Convert lat/lon to pixel coordinates
-            coord c = wm.point_to_pixels(point);
-
-            // Mark first point as pen-down
-            if (first)
-            {
-                cairo_move_to(cr, c.x, c.y);
-                first = false;
-            }
-            else
-            {
-                cairo_line_to(cr, c.x, c.y);
-            }
-        }
+        cairo_fill(cr);
+        return;
     }
-
-    // Draw line and fill
-    set_color(cr, style.fill_color);
     cairo_fill_preserve(cr);
     set_color(cr, style.line_color);
     cairo_set_line_width(cr, style.line_width);
     cairo_stroke(cr);
 }
 
+/**
+ * Trace Geometry Part
+ *
+ * \param[out] cr Image context
+ * \param[in] layer Feature layer
+ * \param[in] part Geometry part
+ * \param[in] px Layer point columns (pixels)
+ * \param[in] py Layer point rows (pixels)
+ */
+void enc_renderer::trace_part(cairo_t *cr, const encdata::feature_set::layer &layer,
+                              const encdata::feature_set::part &part,
+                              const double *px, const double *py)
+{
+    for (std::size_t i = part.first; i < part.first + part.count; i++)
+    {
+        // Mark first point as pen-down
+        if (i == part.first)
+        {
+            cairo_move_to(cr, px[i], py[i]);
+        }
+        else
+        {
+            cairo_line_to(cr, px[i], py[i]);
+        }
+    }
+}
+
 /**
  * Choose Feature Style
  *
- * \param[in] feat Specified feature
+ * \param[in] layer Feature layer
+ * \param[in] idx Feature index
+ * \param[in] cutoff_attr Index of cutoff attribute (-1 if missing)
  * \param[in] lstyle Layer styles
  * \return Selected style
  */
-const simple_style &enc_renderer::get_feat_style(const OGRFeatureUniquePtr &feat,
+const simple_style &enc_renderer::get_feat_style(const encdata::feature_set::layer &layer,
+                                                 std::size_t idx, int cutoff_attr,
                                                  const layer_style &lstyle)
 {
     // Check for alternate feature styles
     if (!lstyle.cutoff_styles.empty())
     {
-        // Get field index
-        int idx = feat->GetFieldIndex(lstyle.cutoff_attr.c_str());
-
-        // Get field value
-        double field_value = (*feat)[idx].GetDouble();
+        // Get field value (NaN if unset, matching no cutoff)
+        double field_value = layer.attr(idx, cutoff_attr);
 
         // If it's less than one of the cutoffs, use the corresponding style
         for (size_t i = 0; i < lstyle.cutoff_styles.size(); i++)
@@ -427,6 +531,43 @@ const simple_style &enc_renderer::get_feat_style(const OGRFeatureUniquePtr &feat
     return lstyle.style;
 }
 
+/**
+ * Get Exported Layers of Style
+ *
+ * Layers are listed once each, with only the attributes used for cutoffs,
+ * and the largest clip margin of any style for the layer.
+ *
+ * \param[in] style Render style
+ * \param[in] tile_size Dimension of output image
+ * \return Layer specifications
+ */
+std::vector<encdata::enc_dataset::layer_spec>
+enc_renderer::get_layer_specs(const render_style &style, int tile_size)
+{
+    std::vector<encdata::enc_dataset::layer_spec> specs;
+    for (const layer_style &lstyle : style.layers)
+    {
+        auto spec = std::find_if(specs.begin(), specs.end(),
+                                 [&](const encdata::enc_dataset::layer_spec &next) {
+                                     return next.name == lstyle.layer_name; });
+        if (spec == specs.end())
+        {
+            specs.push_back({ lstyle.layer_name, std::vector<std::string>() });
+            spec = specs.end() - 1;
+        }
+
+        // Clip margin, as a fraction of tile size (5% if not set)
+        double margin = lstyle.buffer.has_value() ?
+            (double)lstyle.buffer.value() / tile_size : 0.05;
+        spec->margin = std::max(spec->margin, margin);
+        if (!lstyle.cutoff_styles.empty() && !spec->wants(lstyle.cutoff_attr.c_str()))
+        {
+            spec->fields->push_back(lstyle.cutoff_attr);
+        }
+    }
+    return specs;
+}
+
 /**
  * Set Render Color
  *
@@ -475,6 +616,63 @@ void enc_renderer::load_config(const fs::path &config_path)
     {
         land_layer = xml_text(xml_query(root, "land_layer"));
     }
+    unsigned int index_threads = 0;
+    if (!xml_query_all(root, "index_threads").empty())
+    {
+        index_threads = atoi(xml_text(xml_query(root, "index_threads")));
+    }
+    unsigned int clip_threads = 1;
+    if (!xml_query_all(root, "clip_threads").empty())
+    {
+        clip_threads = atoi(xml_text(xml_query(root, "clip_threads")));
+    }
+    std::size_t chart_cache_mb = 256;
+    if (!xml_query_all(root, "chart_cache_mb").empty())
+    {
+        chart_cache_mb = atol(xml_text(xml_query(root, "chart_cache_mb")));
+    }
+    bool watch_charts = false;
+    if (!xml_query_all(root, "watch_charts").empty())
+    {
+        watch_charts = std::string(xml_text(xml_query(root, "watch_charts"))) == "true";
+    }
+    bool chart_store = false;
+    if (!xml_query_all(root, "chart_store").empty())
+    {
+        chart_store = std::string(xml_text(xml_query(root, "chart_store"))) == "true";
+    }
+    bool coverage_mask = false;
+    if (!xml_query_all(root, "coverage_mask").empty())
+    {
+        coverage_mask = std::string(xml_text(xml_query(root, "coverage_mask"))) == "true";
+    }
+    std::string format_name = "png";
+    if (!xml_query_all(root, "tile_format").empty())
+    {
+        format_name = xml_text(xml_query(root, "tile_format"));
+    }
+    png_options png_opts;
+    if (!xml_query_all(root, "png_level").empty() &&
+        !png_options::parse_level(xml_text(xml_query(root, "png_level")), png_opts.level))
+    {
+        throw std::runtime_error("Invalid PNG level");
+    }
+    if (!xml_query_all(root, "png_filter").empty() &&
+        !png_options::parse_filter(xml_text(xml_query(root, "png_filter")), png_opts.filter))
+    {
+        throw std::runtime_error("Invalid PNG filter");
+    }
+    if (!xml_query_all(root, "png_strategy").empty() &&
+        !png_options::parse_strategy(xml_text(xml_query(root, "png_strategy")),
+                                     png_opts.strategy))
+    {
+        throw std::runtime_error("Invalid PNG strategy");
+    }
+    int webp_level = 6;
+    if (!xml_query_all(root, "webp_level").empty())
+    {
+        webp_level = atoi(xml_text(xml_query(root, "webp_level")));
+    }
     fs::path theme_file = xml_text(xml_query(root, "theme_file"));
     fs::path style_path = xml_text(xml_query(root, "style_path"));
     tile_size_ = atoi(xml_text(xml_query(root, "tile_size")));
@@ -495,11 +693,47 @@ void enc_renderer::load_config(const fs::path &config_path)
     printf(" - Theme: %s\n", theme_file.string().c_str());
     printf(" - Styles: %s\n", style_path.string().c_str());
     printf(" - Tile Size: %d\n", tile_size_);
+    printf(" - Tile Format: %s (level %d)\n", format_name.c_str(), png_opts.level);
+    printf(" - WebP: %s (level %d)\n", webp_encoder::available() ? "available" : "not built",
+           webp_level);
     printf(" - Scale Base: %g\n", min_scale0_);
+    printf(" - Chart Cache: %lu MB\n", chart_cache_mb);
+    printf(" - Clip Threads: %u\n", clip_threads);
+    printf(" - Chart Store: %s\n", chart_store ? "true" : "false");
+    printf(" - Coverage Mask: %s\n", coverage_mask ? "true" : "false");
+
+    // Configure tile encoder
+    if (format_name == "png")
+    {
+        format_ = tile_format::PNG;
+    }
+    else if (format_name == "png8")
+    {
+        format_ = tile_format::PNG8;
+    }
+    else if ((format_name == "webp") && webp_encoder::available())
+    {
+        format_ = tile_format::WEBP;
+    }
+    else
+    {
+        throw std::runtime_error("Invalid tile format: " + format_name);
+    }
+    png_ = png_encoder(png_opts);
+    webp_ = webp_encoder(webp_level);
 
     // Configure charts
     enc_.set_cache_path(meta_path);
+    enc_.set_index_threads(index_threads);
+    enc_.set_chart_cache(chart_cache_mb << 20);
+    enc_.set_clip_threads(clip_threads);
+    enc_.set_chart_store(chart_store);
+    enc_.set_coverage_mask(coverage_mask ? 4 * tile_size_ : 0); // Quarter pixel cells
     enc_.load_charts(chart_path);
+    if (watch_charts)
+    {
+        enc_.watch_charts(chart_path);
+    }
 
     // Configure default land layer
     if (!land_path.empty())
@@ -523,6 +757,8 @@ void enc_renderer::load_config(const fs::path &config_path)
             {
                 std::string style_name = p.stem().string() + "-" + theme_name;
                 styles_[style_name] = load_style(p.string(), theme_data);
+                style_layers_[style_name] = get_layer_specs(styles_[style_name], tile_size_);
+                palettes_[style_name] = build_palette(styles_[style_name], theme_data);
                 printf("Loaded: %s\n", style_name.c_str());
             }
         }
@@ -0,0 +1,318 @@
+/**
+ * \file
+ * \brief PNG Encoder
+ *
+ * Encodes rendered tiles (cairo ARGB32 pixels) to PNG with libpng, with
+ * tunable compression level, row filter and deflate strategy. Fully opaque
+ * tiles are written without an alpha channel. Indexed (PNG8) output is also
+ * supported for palette rendered tiles.
+ */
+
+#include <csetjmp>
+#include <cstdlib>
+#include <cstring>
+#include <png.h>
+#include <zlib.h>
+#include <encviz/png_encoder.h>
+
+namespace encviz
+{
+
+/// Filter names, by filter
+static const char *const filter_names[] = { "none", "sub", "up", "avg", "paeth", "all" };
+
+/// libpng filter flags, by filter
+static const int filter_flags[] = {
+    PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP, PNG_FILTER_AVG, PNG_FILTER_PAETH,
+    PNG_ALL_FILTERS
+};
+
+/// Strategy names, by strategy
+static const char *const strategy_names[] = { "default", "filtered", "huffman", "rle", "fixed" };
+
+/// zlib strategies, by strategy
+static const int strategy_values[] = {
+    Z_DEFAULT_STRATEGY, Z_FILTERED, Z_HUFFMAN_ONLY, Z_RLE, Z_FIXED
+};
+
+/**
+ * libpng Write Callback
+ *
+ * \param[in] png PNG context (output vector as I/O pointer)
+ * \param[in] data Data buffer
+ * \param[in] length Length of data buffer
+ */
+static void png_write_to_vector(png_structp png, png_bytep data, png_size_t length)
+{
+    std::vector<uint8_t> *output = (std::vector<uint8_t>*)png_get_io_ptr(png);
+    output->insert(output->end(), data, data + length);
+}
+
+/**
+ * libpng Flush Callback (nothing to flush)
+ *
+ * \param[in] png PNG context
+ */
+static void png_flush_vector(png_structp png)
+{
+}
+
+/**
+ * Unpremultiply Color Channel
+ *
+ * \param[in] c Premultiplied channel
+ * \param[in] a Alpha channel
+ * \return Straight channel
+ */
+static inline uint8_t unpremultiply(uint32_t c, uint32_t a)
+{
+    return (c * 255 + a / 2) / a;
+}
+
+/**
+ * Parse Compression Level
+ *
+ * \param[in] text Compression level (0 to 9)
+ * \param[out] level Parsed level
+ * \return False if not a whole number from 0 to 9
+ */
+bool png_options::parse_level(const char *text, int &level)
+{
+    char *end = nullptr;
+    long value = strtol(text, &end, 10);
+    if ((end == text) || (*end != '\0') || (value < Z_NO_COMPRESSION) ||
+        (value > Z_BEST_COMPRESSION))
+    {
+        return false;
+    }
+    level = value;
+    return true;
+}
+
+/**
+ * Parse Filter Name
+ *
+ * \param[in] name Filter name (none, sub, up, avg, paeth or all)
+ * \param[out] filter Parsed filter
+ * \return False if name is not recognized
+ */
+bool png_options::parse_filter(const char *name, filter_type &filter)
+{
+    for (int i = 0; i <= FILTER_ALL; i++)
+    {
+        if (strcmp(name, filter_names[i]) == 0)
+        {
+            filter = (filter_type)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Parse Strategy Name
+ *
+ * \param[in] name Strategy name (default, filtered, huffman, rle or fixed)
+ * \param[out] strategy Parsed strategy
+ * \return False if name is not recognized
+ */
+bool png_options::parse_strategy(const char *name, strategy_type &strategy)
+{
+    for (int i = 0; i <= STRATEGY_FIXED; i++)
+    {
+        if (strcmp(name, strategy_names[i]) == 0)
+        {
+            strategy = (strategy_type)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Constructor
+ *
+ * \param[in] opts Encoder settings
+ */
+png_encoder::png_encoder(const png_options &opts)
+    : opts_(opts)
+{
+}
+
+/**
+ * Get Encoder Settings
+ *
+ * \return Encoder settings
+ */
+const png_options &png_encoder::options() const
+{
+    return opts_;
+}
+
+/**
+ * Encode Image
+ *
+ * Safe to call concurrently from multiple threads.
+ *
+ * \param[out] out PNG bytestream (replaced)
+ * \param[in] pixels Premultiplied ARGB32 pixels (cairo), by row
+ * \param[in] width Image width
+ * \param[in] height Image height
+ * \return False on encoder failure
+ */
+bool png_encoder::encode(std::vector<uint8_t> &out, const uint32_t *pixels,
+                         int width, int height) const
+{
+    // Chart tiles are usually opaque, so drop alpha if possible
+    std::size_t count = (std::size_t)width * height;
+    bool opaque = true;
+    for (std::size_t i = 0; opaque && (i < count); i++)
+    {
+        opaque = (pixels[i] >> 24) == 0xff;
+    }
+    int channels = opaque ? 3 : 4;
+
+    // Presize output (flat tiles compress well below a byte per pixel)
+    out.clear();
+    out.reserve(count);
+
+    // Row conversion buffer (outside the setjmp scope)
+    std::vector<png_byte> row(width * channels);
+
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING,
+                                              nullptr, nullptr, nullptr);
+    if (png == nullptr)
+    {
+        return false;
+    }
+    png_infop info = png_create_info_struct(png);
+    if ((info == nullptr) || setjmp(png_jmpbuf(png)))
+    {
+        png_destroy_write_struct(&png, &info);
+        out.clear();
+        return false;
+    }
+
+    png_set_write_fn(png, &out, png_write_to_vector, png_flush_vector);
+    png_set_compression_level(png, opts_.level);
+    png_set_compression_strategy(png, strategy_values[opts_.strategy]);
+    png_set_filter(png, PNG_FILTER_TYPE_BASE, filter_flags[opts_.filter]);
+    png_set_IHDR(png, info, width, height, 8,
+                 opaque ? PNG_COLOR_TYPE_RGB : PNG_COLOR_TYPE_RGB_ALPHA,
+                 PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+    png_write_info(png, info);
+
+    // Convert rows from premultiplied native ARGB to straight RGB(A) bytes
+    for (int y = 0; y < height; y++)
+    {
+        const uint32_t *src = pixels + (std::size_t)y * width;
+        png_bytep dst = row.data();
+        for (int x = 0; x < width; x++)
+        {
+            uint32_t p = src[x];
+            uint32_t a = p >> 24;
+            uint32_t r = (p >> 16) & 0xff;
+            uint32_t g = (p >> 8) & 0xff;
+            uint32_t b = p & 0xff;
+            if (opaque)
+            {
+                *dst++ = r;
+                *dst++ = g;
+                *dst++ = b;
+            }
+            else if (a == 0)
+            {
+                memset(dst, 0, 4);
+                dst += 4;
+            }
+            else
+            {
+                *dst++ = (a == 0xff) ? r : unpremultiply(r, a);
+                *dst++ = (a == 0xff) ? g : unpremultiply(g, a);
+                *dst++ = (a == 0xff) ? b : unpremultiply(b, a);
+                *dst++ = a;
+            }
+        }
+        png_write_row(png, row.data());
+    }
+
+    png_write_end(png, nullptr);
+    png_destroy_write_struct(&png, &info);
+    return true;
+}
+
+/**
+ * Encode Indexed Image (PNG8)
+ *
+ * Safe to call concurrently from multiple threads.
+ *
+ * \param[out] out PNG bytestream (replaced)
+ * \param[in] indexes Palette indexes, by row
+ * \param[in] width Image width
+ * \param[in] height Image height
+ * \param[in] palette Color palette
+ * \return False on encoder failure
+ */
+bool png_encoder::encode_indexed(std::vector<uint8_t> &out, const uint8_t *indexes,
+                                 int width, int height, const color_palette &palette) const
+{
+    // Split palette into colors and transparency (only up to last translucent)
+    const std::vector<color> &entries = palette.entries();
+    std::vector<png_color> colors(entries.size());
+    std::vector<png_byte> alphas(entries.size());
+    int alpha_count = 0;
+    for (std::size_t i = 0; i < entries.size(); i++)
+    {
+        colors[i].red = entries[i].red;
+        colors[i].green = entries[i].green;
+        colors[i].blue = entries[i].blue;
+        alphas[i] = entries[i].alpha;
+        if (entries[i].alpha != 0xff)
+        {
+            alpha_count = i + 1;
+        }
+    }
+
+    // Presize output
+    out.clear();
+    out.reserve((std::size_t)width * height / 4);
+
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING,
+                                              nullptr, nullptr, nullptr);
+    if (png == nullptr)
+    {
+        return false;
+    }
+    png_infop info = png_create_info_struct(png);
+    if ((info == nullptr) || setjmp(png_jmpbuf(png)))
+    {
+        png_destroy_write_struct(&png, &info);
+        out.clear();
+        return false;
+    }
+
+    // Row filters rarely help palette images, so none are used
+    png_set_write_fn(png, &out, png_write_to_vector, png_flush_vector);
+    png_set_compression_level(png, opts_.level);
+    png_set_compression_strategy(png, strategy_values[opts_.strategy]);
+    png_set_filter(png, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE);
+    png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_PALETTE,
+                 PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+    png_set_PLTE(png, info, colors.data(), colors.size());
+    if (alpha_count > 0)
+    {
+        png_set_tRNS(png, info, alphas.data(), alpha_count, nullptr);
+    }
+    png_write_info(png, info);
+
+    for (int y = 0; y < height; y++)
+    {
+        png_write_row(png, indexes + (std::size_t)y * width);
+    }
+
+    png_write_end(png, nullptr);
+    png_destroy_write_struct(&png, &info);
+    return true;
+}
+
+}; // ~namespace encviz
@@ -136,6 +136,13 @@ layer_style parse_layer_style(tinyxml2::XMLElement *node,
     child = xml_query(node, "style");
     parsed.style = parse_simple_style(child, theme);
 
+    // Optional clip margin
+    child = xml_query(node, "buffer", true);
+    if (child)
+    {
+        parsed.buffer = atoi(xml_text(child));
+    }
+
     // Optional attribute based cutoffs
     child = xml_query(node, "cutoff_attr", true);
     if (child)
@@ -0,0 +1,109 @@
+/**
+ * \file
+ * \brief Uniform Tile Table
+ *
+ * Many tiles (open water, solid land, no data) render to a single color. This
+ * detects such tiles, and keeps their encoded images so they are only encoded
+ * once per color and format, shared by all requests.
+ */
+
+#include <algorithm>
+#include <mutex>
+#include <encviz/uniform_tiles.h>
+
+namespace encviz
+{
+
+/**
+ * Constructor
+ *
+ * \param[in] max_entries Maximum number of encoded tiles kept
+ */
+uniform_tiles::uniform_tiles(std::size_t max_entries)
+    : max_entries_(max_entries)
+{
+}
+
+/**
+ * Check for Single Color
+ *
+ * \param[in] pixels ARGB32 pixels
+ * \param[in] count Number of pixels
+ * \param[out] pixel The color, if uniform
+ * \return False if more than one color
+ */
+bool uniform_tiles::is_uniform(const uint32_t *pixels, std::size_t count, uint32_t &pixel)
+{
+    if (count == 0)
+    {
+        return false;
+    }
+
+    // Fold differences a block at a time, so the loop vectorizes
+    const uint32_t first = pixels[0];
+    const std::size_t block = 256;
+    for (std::size_t i = 0; i < count; i += block)
+    {
+        std::size_t end = std::min(i + block, count);
+        uint32_t diff = 0;
+        for (std::size_t j = i; j < end; j++)
+        {
+            diff |= pixels[j] ^ first;
+        }
+        if (diff != 0)
+        {
+            return false;
+        }
+    }
+    pixel = first;
+    return true;
+}
+
+/**
+ * Find Encoded Tile
+ *
+ * \param[out] data Encoded image (replaced)
+ * \param[in] format Tile format (as integer)
+ * \param[in] pixel Tile color
+ * \return False if not in table
+ */
+bool uniform_tiles::find(std::vector<uint8_t> &data, int format, uint32_t pixel) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = table_.find(((uint64_t)format << 32) | pixel);
+    if (it == table_.end())
+    {
+        return false;
+    }
+    data = it->second;
+    return true;
+}
+
+/**
+ * Add Encoded Tile
+ *
+ * \param[in] data Encoded image
+ * \param[in] format Tile format (as integer)
+ * \param[in] pixel Tile color
+ */
+void uniform_tiles::insert(const std::vector<uint8_t> &data, int format, uint32_t pixel)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (table_.size() < max_entries_)
+    {
+        table_.emplace(((uint64_t)format << 32) | pixel, data);
+    }
+}
+
+/**
+ * Get Number of Entries
+ *
+ * \return Encoded tiles in table
+ */
+std::size_t uniform_tiles::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return table_.size();
+}
+
+}; // ~namespace encviz
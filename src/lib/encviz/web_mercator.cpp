@@ -7,11 +7,115 @@
  */
 
 #include <cmath>
+#include <cstring>
 #include <encviz/web_mercator.h>
 
+// Clone bulk kernels per instruction set, picked when loaded (x86 only)
+#if defined(__x86_64__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define SIMD_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#endif
+#endif
+#ifndef SIMD_CLONES
+#define SIMD_CLONES
+#endif
+
 namespace encviz
 {
 
+/**
+ * Sine (branch free, for vectorizing)
+ *
+ * \param[in] a Angle (radians, within +/- pi/2)
+ * \return Sine of angle
+ */
+static inline double poly_sin(double a)
+{
+    // Taylor series to a^23, error below 1e-20 over range
+    double a2 = a * a;
+    double p = -3.868170170630684e-23;
+    p = p * a2 + 1.9572941063391263e-20;
+    p = p * a2 - 8.22063524662433e-18;
+    p = p * a2 + 2.8114572543455206e-15;
+    p = p * a2 - 7.647163731819816e-13;
+    p = p * a2 + 1.6059043836821613e-10;
+    p = p * a2 - 2.505210838544172e-08;
+    p = p * a2 + 2.7557319223985893e-06;
+    p = p * a2 - 0.0001984126984126984;
+    p = p * a2 + 0.008333333333333333;
+    p = p * a2 - 0.16666666666666666;
+    return a + a * a2 * p;
+}
+
+/**
+ * Natural Logarithm (branch free, for vectorizing)
+ *
+ * \param[in] v Value (positive, normal)
+ * \return Logarithm of value
+ */
+static inline double poly_log(double v)
+{
+    // Split into exponent and mantissa within [sqrt(1/2), sqrt(2)), with
+    // integer ops only (mantissa bits past sqrt(2) take the next exponent)
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    uint64_t frac = bits & 0x000fffffffffffffULL;
+    uint64_t big = (0x0006a09e667f3bcdULL - frac) >> 63;
+    uint64_t m_bits = frac | ((0x3ffULL - big) << 52);
+    uint64_t e_bits = 0x4330000000000000ULL | (((bits >> 52) & 0x7ff) + big);
+    double m, e;
+    memcpy(&m, &m_bits, sizeof(m));
+    memcpy(&e, &e_bits, sizeof(e));
+    e -= 4503599627370496.0 + 1023; // 2^52 + bias
+
+    // log(m) = 2 atanh(s), series to s^23, error below 1e-17
+    double s = (m - 1) / (m + 1);
+    double s2 = s * s;
+    double p = 0.08695652173913043;
+    p = p * s2 + 0.09523809523809523;
+    p = p * s2 + 0.10526315789473684;
+    p = p * s2 + 0.11764705882352941;
+    p = p * s2 + 0.13333333333333333;
+    p = p * s2 + 0.15384615384615385;
+    p = p * s2 + 0.18181818181818182;
+    p = p * s2 + 0.2222222222222222;
+    p = p * s2 + 0.2857142857142857;
+    p = p * s2 + 0.4;
+    p = p * s2 + 0.6666666666666666;
+    p = p * s2 + 2.0;
+    return e * M_LN2 + s * p;
+}
+
+/**
+ * Project Degrees to Pixels (bulk kernel)
+ *
+ * Uses log(tan(pi/4 + lat/2)) = log((1 + sin(lat)) / (1 - sin(lat))) / 2,
+ * with polynomial sin and log so the loop vectorizes.
+ *
+ * \param[in] x Input longitudes (degrees)
+ * \param[in] y Input latitudes (degrees)
+ * \param[in] count Number of coordinates
+ * \param[out] px Output columns (pixels)
+ * \param[out] py Output rows (pixels)
+ * \param[in] x_scale Pixels per degree longitude
+ * \param[in] x_offset Column of zero longitude
+ * \param[in] y_scale Pixels per unit of log((1 + sin) / (1 - sin)), negated
+ * \param[in] y_offset Row of the equator
+ */
+SIMD_CLONES
+static void project_deg(const double *__restrict x, const double *__restrict y,
+                        std::size_t count, double *__restrict px, double *__restrict py,
+                        double x_scale, double x_offset, double y_scale, double y_offset)
+{
+    // No branches (ie - clamping), or the loop won't vectorize
+    for (std::size_t i = 0; i < count; i++)
+    {
+        double s = poly_sin(y[i] * (M_PI / 180));
+        px[i] = x[i] * x_scale + x_offset;
+        py[i] = poly_log((1 + s) / (1 - s)) * y_scale + y_offset;
+    }
+}
+
 /**
  * Constructor
  *
@@ -155,6 +259,37 @@ coord web_mercator::pixels_to_meters(const coord &in) const
     return out;
 }
 
+/**
+ * Convert coordinate from degrees to pixels
+ *
+ * \param[in] in Input coordinate (degrees)
+ * \return Output coordinate (pixels)
+ */
+coord web_mercator::deg_to_pixels(const coord &in) const
+{
+    return meters_to_pixels(deg_to_meters(in));
+}
+
+/**
+ * Convert coordinates from degrees to pixels, in bulk
+ *
+ * \param[in] x Input longitudes (degrees)
+ * \param[in] y Input latitudes (degrees)
+ * \param[in] count Number of coordinates
+ * \param[out] px Output columns (pixels)
+ * \param[out] py Output rows (pixels)
+ */
+void web_mercator::deg_to_pixels(const double *x, const double *y, std::size_t count,
+                                 double *px, double *py) const
+{
+    // Fold deg_to_meters() and meters_to_pixels() into scale and offset
+    double x_scale = offset_m_ / 180.0 * ppm_;
+    double x_offset = -bbox_m_.MinX * ppm_;
+    double y_scale = -0.5 * offset_m_ / M_PI * ppm_;
+    double y_offset = bbox_m_.MaxY * ppm_;
+    project_deg(x, y, count, px, py, x_scale, x_offset, y_scale, y_offset);
+}
+
 /**
  * Convert OGR Point to pixels
  *
@@ -164,9 +299,7 @@ coord web_mercator::pixels_to_meters(const coord &in) const
 coord web_mercator::point_to_pixels(const OGRPoint &point) const
 {
     // Convert lat/lon to pixel coordinates
-    coord c = { point.getX(), point.getY() };
-    c = deg_to_meters(c);
-    return meters_to_pixels(c);
+    return deg_to_pixels({ point.getX(), point.getY() });
 }
 
 }; // ~namespace encviz
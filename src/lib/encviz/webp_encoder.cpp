@@ -0,0 +1,126 @@
+/**
+ * \file
+ * \brief WebP Encoder
+ *
+ * Encodes rendered tiles (cairo ARGB32 pixels) to lossless WebP, which is
+ * usually much smaller than PNG for flat shaded chart tiles. Only available
+ * when built with libwebp (HAVE_WEBP).
+ */
+
+#include <algorithm>
+#include <encviz/webp_encoder.h>
+#ifdef HAVE_WEBP
+#include <webp/encode.h>
+#endif
+
+namespace encviz
+{
+
+/**
+ * Constructor
+ *
+ * \param[in] level Lossless effort preset (0 = fastest, 9 = smallest)
+ */
+webp_encoder::webp_encoder(int level)
+    : level_(std::clamp(level, 0, 9))
+{
+}
+
+/**
+ * Check Encoder Availability
+ *
+ * \return False if built without libwebp
+ */
+bool webp_encoder::available()
+{
+#ifdef HAVE_WEBP
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Get Effort Preset
+ *
+ * \return Lossless effort preset
+ */
+int webp_encoder::level() const
+{
+    return level_;
+}
+
+/**
+ * Encode Image
+ *
+ * Safe to call concurrently from multiple threads.
+ *
+ * \param[out] out WebP bytestream (replaced)
+ * \param[in] pixels Premultiplied ARGB32 pixels (cairo), by row
+ * \param[in] width Image width
+ * \param[in] height Image height
+ * \return False on encoder failure (or if not available)
+ */
+bool webp_encoder::encode(std::vector<uint8_t> &out, const uint32_t *pixels,
+                          int width, int height) const
+{
+    out.clear();
+#ifdef HAVE_WEBP
+    WebPConfig config;
+    if (!WebPConfigInit(&config) || !WebPConfigLosslessPreset(&config, level_))
+    {
+        return false;
+    }
+
+    WebPPicture pic;
+    if (!WebPPictureInit(&pic))
+    {
+        return false;
+    }
+    pic.use_argb = 1;
+    pic.width = width;
+    pic.height = height;
+    if (!WebPPictureAlloc(&pic))
+    {
+        return false;
+    }
+
+    // WebP takes straight ARGB words, cairo gives premultiplied
+    for (int y = 0; y < height; y++)
+    {
+        const uint32_t *src = pixels + (std::size_t)y * width;
+        uint32_t *dst = pic.argb + (std::size_t)y * pic.argb_stride;
+        for (int x = 0; x < width; x++)
+        {
+            uint32_t p = src[x];
+            uint32_t a = p >> 24;
+            if ((a == 0xff) || (a == 0))
+            {
+                dst[x] = p;
+                continue;
+            }
+            uint32_t r = (((p >> 16) & 0xff) * 255 + a / 2) / a;
+            uint32_t g = (((p >> 8) & 0xff) * 255 + a / 2) / a;
+            uint32_t b = ((p & 0xff) * 255 + a / 2) / a;
+            dst[x] = (a << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+
+    WebPMemoryWriter writer;
+    WebPMemoryWriterInit(&writer);
+    pic.writer = WebPMemoryWrite;
+    pic.custom_ptr = &writer;
+    bool ok = WebPEncode(&config, &pic);
+    if (ok)
+    {
+        out.assign(writer.mem, writer.mem + writer.size);
+    }
+    WebPMemoryWriterClear(&writer);
+    WebPPictureFree(&pic);
+    return ok;
+#else
+    return false;
+#endif
+}
+
+}; // ~namespace encviz
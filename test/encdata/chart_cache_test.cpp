@@ -0,0 +1,150 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <encdata/chart_cache.h>
+using namespace testing;
+using namespace encdata;
+
+/// Charts of one (empty) file, told apart by fingerprint
+static chart_metadata make_chart(const std::filesystem::path &path, int64_t file_time)
+{
+    chart_metadata chart;
+    chart.path = path;
+    chart.scale = 20000;
+    chart.file_size = 1000;
+    chart.file_time = file_time;
+    return chart;
+}
+
+/// Cache only opens S57 data, so write an empty cell
+static std::filesystem::path write_empty_cell(const char *name)
+{
+    GDALAllRegister();
+    std::filesystem::path path = std::filesystem::temp_directory_path() /
+        (std::string(name) + "." + std::to_string(getpid()) + ".000");
+    GDALDriver *drv = GetGDALDriverManager()->GetDriverByName("S57");
+    std::unique_ptr<GDALDataset> ds(
+        (drv != nullptr) ? drv->Create(path.c_str(), 0, 0, 0, GDT_Unknown, nullptr) : nullptr);
+    return ds ? path : std::filesystem::path();
+}
+
+TEST(chart_cache, lru)
+{
+    std::filesystem::path path = write_empty_cell("chart_cache_test");
+    ASSERT_FALSE(path.empty());
+
+    // Each dataset is estimated at 4000 bytes, so two fit
+    chart_cache cache(10000);
+    chart_metadata a = make_chart(path, 1);
+    chart_metadata b = make_chart(path, 2);
+    chart_metadata c = make_chart(path, 3);
+
+    // Reopening is served from cache
+    {
+        chart_cache::handle lease = cache.open(a);
+        ASSERT_NE(lease.get(), nullptr);
+    }
+    {
+        chart_cache::handle lease = cache.open(a);
+    }
+    chart_cache::stats stats = cache.get_stats();
+    ASSERT_EQ(stats.hits, 1u);
+    ASSERT_EQ(stats.misses, 1u);
+    ASSERT_EQ(stats.entries, 1u);
+    ASSERT_EQ(stats.bytes, 4000u);
+
+    // Changed fingerprint is a new chart
+    {
+        chart_cache::handle lease = cache.open(b);
+    }
+    stats = cache.get_stats();
+    ASSERT_EQ(stats.hits, 1u);
+    ASSERT_EQ(stats.misses, 2u);
+    ASSERT_EQ(stats.entries, 2u);
+    ASSERT_EQ(stats.bytes, 8000u);
+    ASSERT_EQ(stats.evictions, 0u);
+
+    // Least recently used (a) goes first once over budget
+    {
+        chart_cache::handle lease = cache.open(c);
+    }
+    stats = cache.get_stats();
+    ASSERT_EQ(stats.entries, 2u);
+    ASSERT_EQ(stats.bytes, 8000u);
+    ASSERT_EQ(stats.evictions, 1u);
+    {
+        chart_cache::handle lease = cache.open(b);
+    }
+    stats = cache.get_stats();
+    ASSERT_EQ(stats.hits, 2u);
+    ASSERT_EQ(stats.misses, 3u);
+    {
+        chart_cache::handle lease = cache.open(a);
+    }
+    stats = cache.get_stats();
+    ASSERT_EQ(stats.hits, 2u);
+    ASSERT_EQ(stats.misses, 4u);
+    ASSERT_EQ(stats.evictions, 2u);
+
+    // Leased datasets are not evicted, idle ones are
+    {
+        chart_cache::handle lease = cache.open(a);
+        cache.set_budget(0);
+        stats = cache.get_stats();
+        ASSERT_EQ(stats.entries, 0u);
+        ASSERT_EQ(stats.bytes, 0u);
+        ASSERT_EQ(stats.evictions, 3u);
+        ASSERT_NE(lease.get(), nullptr);
+    }
+    stats = cache.get_stats();
+    ASSERT_EQ(stats.entries, 0u);
+    ASSERT_EQ(stats.evictions, 4u);
+
+    std::filesystem::remove(path);
+}
+
+// Build with -DENABLE_TSAN=ON to check for data races
+TEST(chart_cache, concurrent_leases)
+{
+    std::filesystem::path path = write_empty_cell("chart_cache_test_leases");
+    ASSERT_FALSE(path.empty());
+
+    // Threads take turns with more charts than fit, so leases are
+    // returned, reused, and evicted while others are held
+    chart_cache cache(10000);
+    const std::vector<chart_metadata> charts = {
+        make_chart(path, 1), make_chart(path, 2), make_chart(path, 3),
+    };
+    const int thread_count = 8;
+    const int iterations = 50;
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++)
+    {
+        threads.emplace_back([&, t]() {
+            for (int n = 0; n < iterations; n++)
+            {
+                chart_cache::handle lease = cache.open(charts[(t + n) % charts.size()]);
+                if ((lease.get() == nullptr) || (lease.get()->GetLayerCount() < 0))
+                {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(failures, 0);
+    chart_cache::stats stats = cache.get_stats();
+    ASSERT_EQ(stats.hits + stats.misses, (uint64_t)(thread_count * iterations));
+    ASSERT_LE(stats.entries, 2u);
+    ASSERT_EQ(stats.bytes, stats.entries * 4000);
+
+    std::filesystem::remove(path);
+}
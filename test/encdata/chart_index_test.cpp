@@ -0,0 +1,63 @@
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <encdata/chart_index.h>
+using namespace testing;
+using namespace encdata;
+
+static OGREnvelope make_bbox(double x0, double y0, double x1, double y1)
+{
+    OGREnvelope bbox;
+    bbox.MinX = x0;
+    bbox.MinY = y0;
+    bbox.MaxX = x1;
+    bbox.MaxY = y1;
+    return bbox;
+}
+
+TEST(chart_index, empty)
+{
+    chart_index index;
+    std::vector<std::size_t> results = {1, 2, 3};
+    index.query(results, make_bbox(-180, -90, 180, 90), 0);
+    ASSERT_TRUE(results.empty());
+}
+
+TEST(chart_index, matches_linear_scan)
+{
+    // Random charts, in ascending scale order
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> lon(-180, 175), lat(-85, 80), size(0.01, 5);
+    std::vector<chart_index::entry> entries;
+    for (int i = 0; i < 3500; i++)
+    {
+        double x = lon(rng), y = lat(rng);
+        entries.push_back({make_bbox(x, y, x + size(rng), y + size(rng)),
+                           1000 * (1 + i / 100)});
+    }
+
+    chart_index index;
+    index.build(entries);
+    ASSERT_EQ(index.size(), entries.size());
+
+    std::vector<std::size_t> results;
+    for (int i = 0; i < 200; i++)
+    {
+        double x = lon(rng), y = lat(rng);
+        OGREnvelope bbox = make_bbox(x, y, x + size(rng), y + size(rng));
+        int scale_min = 1000 * (i % 40);
+
+        // Brute force reference
+        std::vector<std::size_t> expected;
+        for (std::size_t j = 0; j < entries.size(); j++)
+        {
+            if ((scale_min <= entries[j].scale) && bbox.Intersects(entries[j].bbox))
+            {
+                expected.push_back(j);
+            }
+        }
+
+        index.query(results, bbox, scale_min);
+        ASSERT_EQ(results, expected);
+    }
+}
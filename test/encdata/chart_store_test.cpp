@@ -0,0 +1,160 @@
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <encdata/chart_store.h>
+using namespace testing;
+using namespace encdata;
+
+static std::unique_ptr<OGRGeometry> make_geometry(const char *wkt)
+{
+    OGRGeometry *geo = nullptr;
+    OGRGeometryFactory::createFromWkt(wkt, nullptr, &geo);
+    return std::unique_ptr<OGRGeometry>(geo);
+}
+
+static void add_feature(OGRLayer *layer, const char *wkt, double value = NAN)
+{
+    OGRFeature *feat = OGRFeature::CreateFeature(layer->GetLayerDefn());
+    feat->SetGeometryDirectly(make_geometry(wkt).release());
+    if (!std::isnan(value))
+    {
+        feat->SetField("VALSOU", value);
+    }
+    feat->SetField("OBJNAM", "name");
+    layer->CreateFeature(feat);
+    OGRFeature::DestroyFeature(feat);
+}
+
+static OGRLayer *add_layer(GDALDataset *ds, const char *name)
+{
+    OGRLayer *layer = ds->CreateLayer(name);
+    OGRFieldDefn value("VALSOU", OFTReal);
+    OGRFieldDefn text("OBJNAM", OFTString);
+    layer->CreateField(&value);
+    layer->CreateField(&text);
+    return layer;
+}
+
+/// Long line with wiggles far under any band's simplification tolerance
+static std::string make_wiggle(int points)
+{
+    std::string wkt = "LINESTRING (";
+    for (int i = 0; i < points; i++)
+    {
+        wkt += (i ? "," : "") + std::to_string(i * 0.001) + " " +
+            std::to_string((i % 2) * 0.000001);
+    }
+    return wkt + ")";
+}
+
+static const char *point_wkt[] = {
+    "POINT (1 2)",
+    "POINT (3 4)",
+};
+
+static const char *area_wkt[] = {
+    "POLYGON ((0 0,1 0,1 1,0 1,0 0),(0.25 0.25,0.25 0.75,0.75 0.75,0.75 0.25,0.25 0.25))",
+    "MULTIPOLYGON (((2 0,3 0,3 1,2 1,2 0)),((4 0,5 0,5 1,4 1,4 0)))",
+};
+
+TEST(chart_store, round_trip)
+{
+    GDALAllRegister();
+    GDALDriver *drv = GetGDALDriverManager()->GetDriverByName(GDAL_MEM_DRIVER);
+    std::unique_ptr<GDALDataset> ds(drv->Create("", 0, 0, 0, GDT_Unknown, nullptr));
+    OGRLayer *points = add_layer(ds.get(), "SOUNDG");
+    add_feature(points, point_wkt[0], 12.5);
+    add_feature(points, point_wkt[1]);
+    std::string wiggle = make_wiggle(1001);
+    add_feature(add_layer(ds.get(), "COALNE"), wiggle.c_str());
+    OGRLayer *areas = add_layer(ds.get(), "LNDARE");
+    add_feature(areas, area_wkt[0]);
+    add_feature(areas, area_wkt[1]);
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() /
+        ("chart_store_test." + std::to_string(getpid()));
+    chart_metadata chart = { "/charts/US5FL1AA/US5FL1AA.000", 20000 };
+    chart.file_size = 123456;
+    chart.file_time = 1700000000123456789;
+    ASSERT_TRUE(chart_store::write(path, chart, ds.get()));
+
+    // Fingerprint must match
+    chart_metadata other = chart;
+    other.file_time++;
+    ASSERT_TRUE(chart_store::is_current(path, chart));
+    ASSERT_FALSE(chart_store::is_current(path, other));
+
+    chart_store store;
+    ASSERT_TRUE(store.open(path));
+    ASSERT_TRUE(store.matches(chart));
+    ASSERT_FALSE(store.matches(other));
+    ASSERT_EQ(store.find_layer("DEPARE"), nullptr);
+
+    // Numeric attributes only, unset as NaN
+    const chart_store::layer *layer = store.find_layer("SOUNDG");
+    ASSERT_NE(layer, nullptr);
+    ASSERT_EQ(layer->feature_count, 2u);
+    ASSERT_EQ(layer->find_attr("OBJNAM"), -1);
+    int attr = layer->find_attr("VALSOU");
+    ASSERT_GE(attr, 0);
+    ASSERT_EQ(layer->attr(attr, 0), 12.5);
+    ASSERT_TRUE(std::isnan(layer->attr(attr, 1)));
+    OGREnvelope bbox = layer->bbox(1);
+    ASSERT_EQ(bbox.MinX, 3);
+    ASSERT_EQ(bbox.MaxX, 3);
+    ASSERT_EQ(bbox.MinY, 4);
+    ASSERT_EQ(bbox.MaxY, 4);
+    for (std::size_t i = 0; i < 2; i++)
+    {
+        ASSERT_TRUE(layer->geometry(i)->Equals(make_geometry(point_wkt[i]).get()));
+    }
+
+    // Polygon holes and multipolygons survive at full resolution
+    layer = store.find_layer("LNDARE");
+    ASSERT_NE(layer, nullptr);
+    ASSERT_EQ(layer->band, 0u);
+    ASSERT_EQ(layer->feature_count, 2u);
+    bbox = layer->bbox(1);
+    ASSERT_EQ(bbox.MinX, 2);
+    ASSERT_EQ(bbox.MaxX, 5);
+    ASSERT_EQ(bbox.MinY, 0);
+    ASSERT_EQ(bbox.MaxY, 1);
+    for (std::size_t i = 0; i < 2; i++)
+    {
+        std::unique_ptr<OGRGeometry> geo = layer->geometry(i);
+        ASSERT_EQ(wkbFlatten(geo->getGeometryType()),
+                  (i == 0) ? wkbPolygon : wkbMultiPolygon);
+        ASSERT_TRUE(geo->Equals(make_geometry(area_wkt[i]).get()));
+    }
+
+    // Line collapses in band 1, so later bands fall back to it
+    layer = store.find_layer("COALNE");
+    ASSERT_NE(layer, nullptr);
+    ASSERT_EQ(layer->band, 0u);
+    ASSERT_TRUE(layer->geometry(0)->Equals(make_geometry(wiggle.c_str()).get()));
+    layer = store.find_layer("COALNE", chart_store::band_scale(1) - 1);
+    ASSERT_EQ(layer->band, 0u);
+    layer = store.find_layer("COALNE", chart_store::band_scale(1));
+    ASSERT_EQ(layer->band, 1u);
+    layer = store.find_layer("COALNE", chart_store::band_scale(3) * 2);
+    ASSERT_EQ(layer->band, 1u);
+    ASSERT_EQ(layer->parts[0].coord_count, 2u);
+
+    // Points are never generalized
+    layer = store.find_layer("SOUNDG", chart_store::band_scale(3));
+    ASSERT_EQ(layer->band, 0u);
+
+    // Other versions are rejected
+    FILE *handle = fopen(path.c_str(), "r+b");
+    ASSERT_NE(handle, nullptr);
+    uint32_t bad_version = chart_store::version + 1;
+    fseek(handle, 8, SEEK_SET);
+    fwrite(&bad_version, sizeof(bad_version), 1, handle);
+    fclose(handle);
+    ASSERT_FALSE(chart_store::is_current(path, chart));
+    ASSERT_FALSE(chart_store().open(path));
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <condition_variable>
+#include <gtest/gtest.h>
+#include <encdata/chart_watcher.h>
+using namespace testing;
+using namespace encdata;
+
+/// Collects watcher callbacks
+struct change_log
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<std::set<std::filesystem::path>> changes;
+
+    void add(const std::set<std::filesystem::path> &paths)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        changes.push_back(paths);
+        cond.notify_all();
+    }
+
+    std::size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return changes.size();
+    }
+
+    bool wait_for(std::size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cond.wait_for(lock, std::chrono::seconds(5),
+                             [&]() { return changes.size() >= count; });
+    }
+};
+
+TEST(chart_watcher, write_and_delete)
+{
+    std::filesystem::path root = std::filesystem::temp_directory_path() /
+        ("chart_watcher_test." + std::to_string(getpid()));
+    std::filesystem::create_directories(root / "US5FL1AA");
+    std::filesystem::path path = root / "US5FL1AA" / "US5FL1AA.000";
+
+    const int settle_ms = 50;
+    change_log log;
+    {
+        chart_watcher watcher(root, [&](const std::set<std::filesystem::path> &paths) {
+            log.add(paths);
+        }, settle_ms);
+
+        // Pauses longer than settle time, nothing reported while still open
+        FILE *handle = fopen(path.c_str(), "wb");
+        ASSERT_NE(handle, nullptr);
+        for (int i = 0; i < 4; i++)
+        {
+            fputs("partial chart data\n", handle);
+            fflush(handle);
+            std::this_thread::sleep_for(std::chrono::milliseconds(4 * settle_ms));
+        }
+        ASSERT_EQ(log.size(), 0u);
+        fclose(handle);
+
+        // One change once closed
+        ASSERT_TRUE(log.wait_for(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(4 * settle_ms));
+        ASSERT_EQ(log.size(), 1u);
+        ASSERT_EQ(log.changes[0], std::set<std::filesystem::path>({ path }));
+
+        // One change for delete
+        std::filesystem::remove(path);
+        ASSERT_TRUE(log.wait_for(2));
+        std::this_thread::sleep_for(std::chrono::milliseconds(4 * settle_ms));
+        ASSERT_EQ(log.size(), 2u);
+        ASSERT_EQ(log.changes[1], std::set<std::filesystem::path>({ path }));
+    }
+
+    std::filesystem::remove_all(root);
+}
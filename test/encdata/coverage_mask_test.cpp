@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <ogr_geometry.h>
+#include <encdata/coverage_mask.h>
+using namespace testing;
+using namespace encdata;
+
+static OGRPolygon make_rect(double x0, double y0, double x1, double y1)
+{
+    OGRLinearRing ring;
+    ring.addPoint(x0, y0);
+    ring.addPoint(x1, y0);
+    ring.addPoint(x1, y1);
+    ring.addPoint(x0, y1);
+    ring.addPoint(x0, y0);
+
+    OGRPolygon poly;
+    poly.addRing(&ring);
+    return poly;
+}
+
+TEST(coverage_mask, fill)
+{
+    OGREnvelope bbox;
+    bbox.MinX = 0;
+    bbox.MinY = 0;
+    bbox.MaxX = 10;
+    bbox.MaxY = 10;
+    coverage_mask mask(bbox, 100, 100);
+    ASSERT_EQ(mask.remaining(), 10000);
+
+    // Left half
+    ASSERT_EQ(mask.add(make_rect(-1, -1, 5, 11)), 5000);
+    ASSERT_FALSE(mask.full());
+
+    // Already covered
+    ASSERT_EQ(mask.add(make_rect(1, 1, 4, 4)), 0);
+
+    // Right half, with a hole
+    OGRPolygon right = make_rect(5, -1, 11, 11);
+    OGRLinearRing hole;
+    hole.addPoint(7, 7);
+    hole.addPoint(8, 7);
+    hole.addPoint(8, 8);
+    hole.addPoint(7, 8);
+    hole.addPoint(7, 7);
+    right.addRing(&hole);
+    ASSERT_EQ(mask.add(right), 4900);
+    ASSERT_EQ(mask.remaining(), 100);
+
+    // Fill hole
+    ASSERT_EQ(mask.add(make_rect(6, 6, 9, 9)), 100);
+    ASSERT_TRUE(mask.full());
+}
+
+TEST(coverage_mask, restrict)
+{
+    OGREnvelope bbox;
+    bbox.MinX = 0;
+    bbox.MinY = 0;
+    bbox.MaxX = 10;
+    bbox.MaxY = 10;
+    coverage_mask mask(bbox, 70, 70);
+
+    // Only lower left quarter must be covered
+    mask.restrict(make_rect(0, 0, 5, 5));
+    ASSERT_EQ(mask.remaining(), 35 * 35);
+    ASSERT_EQ(mask.add(make_rect(4, 4, 10, 10)), 7 * 7);
+    ASSERT_EQ(mask.add(make_rect(0, 0, 5, 5)), 35 * 35 - 7 * 7);
+    ASSERT_TRUE(mask.full());
+}
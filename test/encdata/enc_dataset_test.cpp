@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include <gtest/gtest.h>
+#include <cpl_vsi.h>
+#include <encdata/enc_dataset.h>
+#include "synthetic_chart.h"
+using namespace testing;
+using namespace encdata;
+
+static const char *land_json =
+    "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\","
+    "\"properties\":{\"CATLND\":1},\"geometry\":{\"type\":\"Polygon\","
+    "\"coordinates\":[[[0,0],[10,0],[10,10],[0,10],[0,0]]]}}]}";
+
+static OGREnvelope make_bbox(double x0, double y0, double x1, double y1)
+{
+    OGREnvelope bbox;
+    bbox.MinX = x0;
+    bbox.MinY = y0;
+    bbox.MaxX = x1;
+    bbox.MaxY = y1;
+    return bbox;
+}
+
+// Build with -DENABLE_TSAN=ON to check for data races
+TEST(enc_dataset, concurrent_export)
+{
+    GDALAllRegister();
+    const char *land_path = "/vsimem/enc_dataset_test_land.geojson";
+    VSIFCloseL(VSIFileFromMemBuffer(land_path, (GByte*)land_json,
+                                    strlen(land_json), FALSE));
+
+    // Chart east of the land, read from its chart store
+    std::filesystem::path root = std::filesystem::temp_directory_path() /
+        ("enc_dataset_test." + std::to_string(getpid()));
+    ASSERT_TRUE(write_synthetic_chart(root / "charts", root / "meta", "TEST0001",
+                                      make_bbox(20, 0, 30, 10), 50000));
+
+    enc_dataset enc;
+    enc.set_cache_path(root / "meta");
+    enc.set_chart_store(true);
+    enc.load_charts((root / "charts").string());
+    enc.set_default_land(land_path, "");
+
+    // Chart is indexed from metadata, not parsed
+    const std::vector<enc_dataset::layer_spec> chart_layers = {
+        { "DEPARE", std::vector<std::string>({ "DRVAL1" }) },
+        { "SOUNDG", std::vector<std::string>() },
+    };
+    feature_set check;
+    ASSERT_TRUE(enc.export_data(check, chart_layers, make_bbox(20, 0, 30, 10), 0));
+    ASSERT_NE(check.find_layer("DEPARE"), nullptr);
+    ASSERT_EQ(check.find_layer("DEPARE")->size(), 2);
+
+    // Alternate feature set (of land, then chart) and dataset exports of
+    // overlapping tiles
+    const int thread_count = 8;
+    const int iterations = 50;
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++)
+    {
+        threads.emplace_back([&, t]() {
+            feature_set fs;
+            GDALDriver *drv = GetGDALDriverManager()->GetDriverByName(GDAL_MEM_DRIVER);
+            for (int n = 0; n < iterations; n++)
+            {
+                int k = (t + n) % 8;
+                OGREnvelope bbox = make_bbox(k, k, k + 4, k + 4);
+                if ((t % 2) == 0)
+                {
+                    const feature_set::layer *layer;
+                    // No attributes requested, so none are exported
+                    if (!enc.export_data(fs, { { "LNDARE", std::vector<std::string>() } },
+                                         bbox, 0) ||
+                        ((layer = fs.find_layer("LNDARE")) == nullptr) ||
+                        (layer->size() != 1) ||
+                        (layer->find_attr("CATLND") >= 0))
+                    {
+                        failures++;
+                        continue;
+                    }
+                    for (std::size_t i = 0; i < layer->x.size(); i++)
+                    {
+                        if ((layer->x[i] < bbox.MinX) || (layer->x[i] > bbox.MaxX) ||
+                            (layer->y[i] < bbox.MinY) || (layer->y[i] > bbox.MaxY))
+                        {
+                            failures++;
+                            break;
+                        }
+                    }
+
+                    // Chart tiles, with both depth areas where the tile
+                    // crosses the middle of the chart
+                    bbox = make_bbox(20.5 + k, k, 24.5 + k, 4 + k);
+                    const feature_set::layer *depths;
+                    if (!enc.export_data(fs, chart_layers, bbox, 0) ||
+                        ((depths = fs.find_layer("DEPARE")) == nullptr) ||
+                        (depths->size() != (((k >= 1) && (k <= 4)) ? 2u : 1u)) ||
+                        (depths->find_attr("DRVAL1") < 0))
+                    {
+                        failures++;
+                        continue;
+                    }
+                    for (std::size_t i = 0; i < depths->x.size(); i++)
+                    {
+                        if ((depths->x[i] < bbox.MinX) || (depths->x[i] > bbox.MaxX) ||
+                            (depths->y[i] < bbox.MinY) || (depths->y[i] > bbox.MaxY))
+                        {
+                            failures++;
+                            break;
+                        }
+                    }
+                }
+                else
+                {
+                    std::unique_ptr<GDALDataset> ds(drv->Create("", 0, 0, 0, GDT_Unknown, nullptr));
+                    OGRLayer *layer;
+                    if (!enc.export_data(ds.get(), { "LNDARE" }, bbox, 0) ||
+                        ((layer = ds->GetLayerByName("LNDARE")) == nullptr) ||
+                        (layer->GetFeatureCount() != 1))
+                    {
+                        failures++;
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    VSIUnlink(land_path);
+    std::filesystem::remove_all(root);
+
+    ASSERT_EQ(failures, 0);
+}
+
+TEST(enc_dataset, layer_margin)
+{
+    GDALAllRegister();
+    const char *land_path = "/vsimem/enc_dataset_test_margin.geojson";
+    VSIFCloseL(VSIFileFromMemBuffer(land_path, (GByte*)land_json,
+                                    strlen(land_json), FALSE));
+
+    enc_dataset enc;
+    enc.set_default_land(land_path, "");
+
+    // Land clipped to the tile grown by a quarter on each side
+    enc_dataset::layer_spec spec = { "LNDARE", std::vector<std::string>() };
+    spec.margin = 0.25;
+    feature_set fs;
+    ASSERT_TRUE(enc.export_data(fs, { spec }, make_bbox(4, 4, 6, 6), 0));
+    VSIUnlink(land_path);
+
+    const feature_set::layer *layer = fs.find_layer("LNDARE");
+    ASSERT_NE(layer, nullptr);
+    ASSERT_EQ(layer->size(), 1);
+    ASSERT_DOUBLE_EQ(*std::min_element(layer->x.begin(), layer->x.end()), 3.5);
+    ASSERT_DOUBLE_EQ(*std::max_element(layer->x.begin(), layer->x.end()), 6.5);
+    ASSERT_DOUBLE_EQ(*std::min_element(layer->y.begin(), layer->y.end()), 3.5);
+    ASSERT_DOUBLE_EQ(*std::max_element(layer->y.begin(), layer->y.end()), 6.5);
+}
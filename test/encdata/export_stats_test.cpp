@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include <encdata/export_stats.h>
+using namespace testing;
+using namespace encdata;
+
+TEST(export_stats, add)
+{
+    export_stats a;
+    a.exports = 1;
+    a.charts_selected = 2;
+    a.stage_ns[export_stats::CLIP] = 100;
+    a.layers.push_back({ "LNDARE", 5, 3 });
+
+    export_stats b;
+    b.exports = 1;
+    b.charts_selected = 1;
+    b.stage_ns[export_stats::CLIP] = 50;
+    b.layers.push_back({ "DEPARE", 4, 4 });
+    b.layers.push_back({ "LNDARE", 1, 1 });
+
+    export_stats total;
+    total.add(a);
+    total.add(b);
+    ASSERT_EQ(total.exports, 2);
+    ASSERT_EQ(total.charts_selected, 3);
+    ASSERT_EQ(total.stage_ns[export_stats::CLIP], 150);
+    ASSERT_EQ(total.layers.size(), 2);
+    ASSERT_EQ(total.layers[0].name, "LNDARE");
+    ASSERT_EQ(total.layers[0].features_in, 6);
+    ASSERT_EQ(total.layers[0].features_out, 4);
+    ASSERT_EQ(total.layers[1].name, "DEPARE");
+    ASSERT_NE(total.to_string().find("layer DEPARE: in=4 out=4"), std::string::npos);
+
+    total.clear();
+    ASSERT_EQ(total.exports, 0);
+    ASSERT_TRUE(total.layers.empty());
+}
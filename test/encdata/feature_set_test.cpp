@@ -0,0 +1,86 @@
+#include <cmath>
+#include <memory>
+#include <gtest/gtest.h>
+#include <encdata/feature_set.h>
+using namespace testing;
+using namespace encdata;
+
+static std::unique_ptr<OGRGeometry> from_wkt(const char *wkt)
+{
+    OGRGeometry *geo = nullptr;
+    EXPECT_EQ(OGRGeometryFactory::createFromWkt(wkt, nullptr, &geo), OGRERR_NONE);
+    return std::unique_ptr<OGRGeometry>(geo);
+}
+
+TEST(feature_set, geometry)
+{
+    feature_set fs;
+    feature_set::layer &layer = fs.add_layer("LNDARE");
+    layer.add_feature(*from_wkt("MULTIPOLYGON (((0 0,10 0,10 10,0 0),(1 1,2 1,2 2,1 1)),"
+                                "((20 20,30 20,30 30,20 20)))"));
+    layer.add_feature(*from_wkt("POINT Z (1 2 3)"), false);
+    ASSERT_EQ(layer.size(), 2);
+
+    const feature_set::feature &poly = layer.features[0];
+    ASSERT_EQ(poly.part_count, 3);
+    ASSERT_FALSE(poly.is_3d);
+    ASSERT_TRUE(poly.outline);
+    ASSERT_EQ(layer.parts[0].kind, OUTER_RING);
+    ASSERT_EQ(layer.parts[1].kind, INNER_RING);
+    ASSERT_EQ(layer.parts[2].kind, OUTER_RING);
+    ASSERT_EQ(layer.parts[2].first, 8);
+    ASSERT_EQ(layer.parts[2].count, 4);
+
+    const feature_set::feature &point = layer.features[1];
+    ASSERT_TRUE(point.is_3d);
+    ASSERT_FALSE(point.outline);
+    ASSERT_EQ(layer.parts[point.part_first].kind, POINT);
+    ASSERT_EQ(layer.z[layer.parts[point.part_first].first], 3);
+}
+
+TEST(feature_set, unsupported_geometry)
+{
+    // Curves are dropped, as in chart stores, leaving a feature without parts
+    feature_set fs;
+    feature_set::layer &layer = fs.add_layer("COALNE");
+    layer.add_feature(*from_wkt("CIRCULARSTRING (0 0,1 1,2 0)"));
+    layer.add_feature(*from_wkt("GEOMETRYCOLLECTION (CIRCULARSTRING (0 0,1 1,2 0),"
+                                "LINESTRING (0 0,1 1))"));
+    ASSERT_EQ(layer.size(), 2);
+    ASSERT_EQ(layer.features[0].part_count, 0);
+    ASSERT_EQ(layer.features[1].part_count, 1);
+    ASSERT_EQ(layer.parts[layer.features[1].part_first].kind, LINE);
+}
+
+TEST(feature_set, attributes)
+{
+    feature_set fs;
+    feature_set::layer &layer = fs.add_layer("DEPARE");
+    std::size_t first = layer.add_feature(*from_wkt("POINT (0 0)"));
+    std::size_t attr = layer.add_attr("DRVAL1");
+    std::size_t second = layer.add_feature(*from_wkt("POINT (1 1)"));
+    layer.set_attr(second, attr, 5);
+
+    ASSERT_EQ(layer.add_attr("DRVAL1"), attr);
+    ASSERT_EQ(layer.find_attr("DRVAL1"), (int)attr);
+    ASSERT_EQ(layer.find_attr("DRVAL2"), -1);
+    ASSERT_TRUE(std::isnan(layer.attr(first, attr)));
+    ASSERT_EQ(layer.attr(second, attr), 5);
+    ASSERT_TRUE(std::isnan(layer.attr(second, -1)));
+}
+
+TEST(feature_set, reuse)
+{
+    feature_set fs;
+    fs.add_layer("LNDARE").add_feature(*from_wkt("POINT (0 0)"));
+    fs.add_layer("DEPARE");
+    ASSERT_EQ(fs.size(), 2);
+
+    fs.clear();
+    ASSERT_EQ(fs.size(), 0);
+    ASSERT_EQ(fs.find_layer("LNDARE"), nullptr);
+
+    feature_set::layer &layer = fs.add_layer("SOUNDG");
+    ASSERT_EQ(layer.size(), 0);
+    ASSERT_EQ(fs.find_layer("SOUNDG"), &layer);
+}
@@ -0,0 +1,103 @@
+#include <cmath>
+#include <string>
+#include <gtest/gtest.h>
+#include <cpl_vsi.h>
+#include <gdal_priv.h>
+#include <encdata/land_index.h>
+using namespace testing;
+using namespace encdata;
+
+static OGREnvelope make_bbox(double x0, double y0, double x1, double y1)
+{
+    OGREnvelope bbox;
+    bbox.MinX = x0;
+    bbox.MinY = y0;
+    bbox.MaxX = x1;
+    bbox.MaxY = y1;
+    return bbox;
+}
+
+TEST(land_index, query)
+{
+    // Circle of radius 10, with far more points than fit in one piece
+    std::string json = "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\","
+        "\"properties\":{},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[[";
+    const int points = 4000;
+    for (int i = 0; i <= points; i++)
+    {
+        double angle = 2 * M_PI * (i % points) / points;
+        json += ((i > 0) ? ",[" : "[") + std::to_string(10 * cos(angle)) + "," +
+            std::to_string(10 * sin(angle)) + "]";
+    }
+    json += "]]}}]}";
+
+    GDALAllRegister();
+    const char *land_path = "/vsimem/land_index_test.geojson";
+    VSIFCloseL(VSIFileFromMemBuffer(land_path, (GByte*)json.data(), json.size(), FALSE));
+    land_index land;
+    ASSERT_TRUE(land.load(land_path, ""));
+    VSIUnlink(land_path);
+    ASSERT_FALSE(land.empty());
+
+    // Small area on the edge only touches nearby pieces, returned as split
+    std::vector<std::unique_ptr<OGRGeometry>> out;
+    land.query(out, make_bbox(9, -1, 11, 1));
+    ASSERT_FALSE(out.empty());
+    OGREnvelope bbox;
+    for (const std::unique_ptr<OGRGeometry> &piece : out)
+    {
+        OGREnvelope next;
+        piece->getEnvelope(&next);
+        bbox.Merge(next);
+    }
+    ASSERT_LT(bbox.MaxY - bbox.MinY, 20);
+
+    // Nothing outside the circle's extent
+    land.query(out, make_bbox(20, 20, 30, 30));
+    ASSERT_TRUE(out.empty());
+
+    // Missing file
+    ASSERT_FALSE(land.load("/vsimem/missing.geojson", ""));
+    ASSERT_TRUE(land.empty());
+}
+
+TEST(land_index, small_pieces)
+{
+    // Grid of islands, each far too small to split
+    const int grid = 64;
+    std::string json = "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\","
+        "\"properties\":{},\"geometry\":{\"type\":\"MultiPolygon\",\"coordinates\":[";
+    for (int i = 0; i < grid; i++)
+    {
+        for (int j = 0; j < grid; j++)
+        {
+            std::string x0 = std::to_string(i + 0.25), x1 = std::to_string(i + 0.75);
+            std::string y0 = std::to_string(j + 0.25), y1 = std::to_string(j + 0.75);
+            json += std::string(((i > 0) || (j > 0)) ? "," : "") +
+                "[[[" + x0 + "," + y0 + "],[" + x1 + "," + y0 + "],[" + x1 + "," + y1 +
+                "],[" + x0 + "," + y1 + "],[" + x0 + "," + y0 + "]]]";
+        }
+    }
+    json += "]}}]}";
+
+    GDALAllRegister();
+    const char *land_path = "/vsimem/land_index_test_grid.geojson";
+    VSIFCloseL(VSIFileFromMemBuffer(land_path, (GByte*)json.data(), json.size(), FALSE));
+    land_index land;
+    ASSERT_TRUE(land.load(land_path, ""));
+    VSIUnlink(land_path);
+
+    // Only islands near the query are checked, not the whole grid
+    std::vector<std::unique_ptr<OGRGeometry>> out;
+    std::size_t checked = land.query(out, make_bbox(10.4, 20.4, 10.6, 20.6));
+    ASSERT_EQ(out.size(), 1u);
+    ASSERT_LT(checked, 32u);
+
+    // Query across a few islands finds all of them
+    land.query(out, make_bbox(10.4, 20.4, 12.6, 21.6));
+    ASSERT_EQ(out.size(), 6u);
+
+    // Everything is still found
+    land.query(out, make_bbox(0, 0, grid, grid));
+    ASSERT_EQ(out.size(), (std::size_t)(grid * grid));
+}
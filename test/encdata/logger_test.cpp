@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <encdata/logger.h>
+using namespace testing;
+using namespace encdata;
+
+TEST(logger, levels)
+{
+    log_level level;
+    ASSERT_TRUE(logger::parse_level("warn", level));
+    ASSERT_EQ(level, log_level::WARN);
+    ASSERT_FALSE(logger::parse_level("verbose", level));
+
+    logger &log = logger::get();
+    log.set_level(log_level::WARN);
+    ASSERT_FALSE(log.enabled(log_level::DEBUG));
+    ASSERT_FALSE(log.enabled(log_level::INFO));
+    ASSERT_TRUE(log.enabled(log_level::WARN));
+    ASSERT_TRUE(log.enabled(log_level::ERROR));
+    log.set_level(log_level::INFO);
+}
+
+TEST(logger, concurrent_write)
+{
+    logger &log = logger::get();
+    log.set_level(log_level::INFO);
+
+    // Disabled levels never evaluate their arguments
+    int evaluated = 0;
+    LOG_DEBUG("%d", ++evaluated);
+    ASSERT_EQ(evaluated, 0);
+
+    // Capture output
+    log.flush();
+    FILE *out = tmpfile();
+    ASSERT_NE(out, nullptr);
+    log.set_output(out);
+    uint64_t dropped = log.dropped();
+
+    // Fewer lines than ring slots, so nothing may be dropped
+    const int thread_count = 4;
+    const int line_count = 100;
+    const std::string padding(200, 'x');
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++)
+    {
+        threads.emplace_back([t, &padding]() {
+            for (int i = 0; i < line_count; i++)
+            {
+                LOG_INFO("thread=%d line=%d %s", t, i, padding.c_str());
+            }
+        });
+    }
+    for (std::thread &next : threads)
+    {
+        next.join();
+    }
+    log.flush();
+    log.set_output(stdout);
+    ASSERT_EQ(log.dropped(), dropped);
+
+    // Every line arrives once, whole, and in order for its thread
+    std::vector<int> next_line(thread_count, 0);
+    char text[1024];
+    rewind(out);
+    while (fgets(text, sizeof(text), out) != nullptr)
+    {
+        int t, i;
+        char rest[512];
+        const char *body = strstr(text, "thread=");
+        ASSERT_NE(body, nullptr) << text;
+        ASSERT_NE(strstr(text, " info "), nullptr) << text;
+        ASSERT_EQ(sscanf(body, "thread=%d line=%d %511s", &t, &i, rest), 3) << text;
+        ASSERT_TRUE((t >= 0) && (t < thread_count)) << text;
+        ASSERT_EQ(i, next_line[t]) << text;
+        ASSERT_EQ(padding, rest) << text;
+        next_line[t]++;
+    }
+    fclose(out);
+    for (int t = 0; t < thread_count; t++)
+    {
+        ASSERT_EQ(next_line[t], line_count);
+    }
+}
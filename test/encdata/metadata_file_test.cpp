@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <vector>
+#include <gtest/gtest.h>
+#include <encdata/metadata_file.h>
+using namespace testing;
+using namespace encdata;
+
+static OGREnvelope make_bbox(double x0, double y0, double x1, double y1)
+{
+    OGREnvelope bbox;
+    bbox.MinX = x0;
+    bbox.MinY = y0;
+    bbox.MaxX = x1;
+    bbox.MaxY = y1;
+    return bbox;
+}
+
+TEST(metadata_file, round_trip)
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() /
+        ("metadata_file_test." + std::to_string(getpid()));
+
+    chart_metadata a = { "/charts/US5FL1AA/US5FL1AA.000", 20000,
+                         make_bbox(-82, 27, -81, 28) };
+    a.coverage = { make_bbox(-82, 27, -81.5, 28), make_bbox(-81.5, 27, -81, 27.5) };
+    a.file_size = 123456;
+    a.file_time = 1700000000123456789;
+    a.edition = 7;
+    a.update = 3;
+    a.store_version = 5;
+    a.coverage_wkb = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x00 };
+    chart_metadata b = { "/charts/US3FL10M/US3FL10M.000", 250000,
+                         make_bbox(-84, 24, -80, 29) };
+    ASSERT_TRUE(metadata_file::write(path, {&a, &b}));
+
+    metadata_file file;
+    ASSERT_TRUE(file.open(path));
+    ASSERT_EQ(file.size(), 2u);
+
+    const metadata_file::record *rec = file.find(a.path);
+    ASSERT_NE(rec, nullptr);
+    ASSERT_TRUE(metadata_file::matches(*rec, a));
+    ASSERT_FALSE(metadata_file::matches(*rec, b));
+    ASSERT_EQ(metadata_file::store_version(*rec), a.store_version);
+    chart_metadata meta;
+    meta.path = a.path;
+    file.copy(*rec, meta);
+    ASSERT_EQ(meta.path, a.path);
+    ASSERT_EQ(meta.scale, a.scale);
+    ASSERT_EQ(meta.bbox.MinX, a.bbox.MinX);
+    ASSERT_EQ(meta.bbox.MaxY, a.bbox.MaxY);
+    ASSERT_EQ(meta.coverage.size(), 2u);
+    ASSERT_EQ(meta.coverage[1].MinX, -81.5);
+    ASSERT_EQ(meta.file_size, a.file_size);
+    ASSERT_EQ(meta.file_time, a.file_time);
+    ASSERT_EQ(meta.edition, a.edition);
+    ASSERT_EQ(meta.update, a.update);
+    ASSERT_EQ(meta.store_version, a.store_version);
+    ASSERT_EQ(meta.coverage_wkb, a.coverage_wkb);
+
+    rec = file.find(b.path);
+    ASSERT_NE(rec, nullptr);
+    file.copy(*rec, meta);
+    ASSERT_EQ(meta.scale, b.scale);
+    ASSERT_TRUE(meta.coverage.empty());
+    ASSERT_TRUE(meta.coverage_wkb.empty());
+    ASSERT_EQ(meta.store_version, 0u);
+
+    ASSERT_EQ(file.find("/charts/missing.000"), nullptr);
+
+    // Truncated files are rejected
+    file.close();
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    ASSERT_FALSE(file.open(path));
+
+    std::filesystem::remove(path);
+}
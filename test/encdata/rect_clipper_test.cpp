@@ -0,0 +1,76 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <encdata/rect_clipper.h>
+using namespace testing;
+using namespace encdata;
+
+static OGREnvelope make_bbox(double x0, double y0, double x1, double y1)
+{
+    OGREnvelope bbox;
+    bbox.MinX = x0;
+    bbox.MinY = y0;
+    bbox.MaxX = x1;
+    bbox.MaxY = y1;
+    return bbox;
+}
+
+static std::unique_ptr<OGRGeometry> from_wkt(const char *wkt)
+{
+    OGRGeometry *geo = nullptr;
+    EXPECT_EQ(OGRGeometryFactory::createFromWkt(wkt, nullptr, &geo), OGRERR_NONE);
+    return std::unique_ptr<OGRGeometry>(geo);
+}
+
+TEST(rect_clipper, points)
+{
+    rect_clipper clipper(make_bbox(0, 0, 10, 10));
+    ASSERT_TRUE(clipper.clip(*from_wkt("POINT (5 5)")));
+    ASSERT_FALSE(clipper.clip(*from_wkt("POINT (15 5)")));
+
+    auto out = clipper.clip(*from_wkt("MULTIPOINT (5 5,15 5,1 1)"));
+    ASSERT_TRUE(out);
+    ASSERT_EQ(wkbFlatten(out->getGeometryType()), wkbMultiPoint);
+    ASSERT_EQ(out->toMultiPoint()->getNumGeometries(), 2);
+}
+
+TEST(rect_clipper, lines)
+{
+    rect_clipper clipper(make_bbox(0, 0, 10, 10));
+    ASSERT_FALSE(clipper.clip(*from_wkt("LINESTRING (-5 -5,-5 15)")));
+
+    // Crossing once
+    auto out = clipper.clip(*from_wkt("LINESTRING (-5 5,5 5)"));
+    ASSERT_TRUE(out);
+    ASSERT_TRUE(out->Equals(from_wkt("LINESTRING (0 5,5 5)").get()));
+
+    // Leaving and re-entering splits line
+    out = clipper.clip(*from_wkt("LINESTRING (5 5,15 5,15 8,5 8)"));
+    ASSERT_TRUE(out);
+    ASSERT_TRUE(out->Equals(from_wkt("MULTILINESTRING ((5 5,10 5),(10 8,5 8))").get()));
+
+    // Elevation is interpolated
+    out = clipper.clip(*from_wkt("LINESTRING (-10 5 0,10 5 20)"));
+    ASSERT_TRUE(out);
+    ASSERT_TRUE(out->Is3D());
+    ASSERT_DOUBLE_EQ(out->toLineString()->getZ(0), 10);
+}
+
+TEST(rect_clipper, polygons)
+{
+    rect_clipper clipper(make_bbox(0, 0, 10, 10));
+    ASSERT_FALSE(clipper.clip(*from_wkt("POLYGON ((20 20,30 20,30 30,20 20))")));
+
+    // Matches general intersection
+    auto poly = from_wkt("POLYGON ((-5 -5,5 -5,5 5,-5 5,-5 -5),(-2 -2,2 -2,2 2,-2 2,-2 -2))");
+    auto rect = from_wkt("POLYGON ((0 0,10 0,10 10,0 10,0 0))");
+    std::unique_ptr<OGRGeometry> expect(poly->Intersection(rect.get()));
+    auto out = clipper.clip(*poly);
+    ASSERT_TRUE(out);
+    ASSERT_EQ(wkbFlatten(out->getGeometryType()), wkbPolygon);
+    ASSERT_DOUBLE_EQ(out->toPolygon()->get_Area(), expect->toPolygon()->get_Area());
+
+    // Enclosing polygon becomes rectangle
+    out = clipper.clip(*from_wkt("POLYGON ((-5 -5,15 -5,15 15,-5 15,-5 -5))"));
+    ASSERT_TRUE(out);
+    ASSERT_DOUBLE_EQ(out->toPolygon()->get_Area(), 100);
+}
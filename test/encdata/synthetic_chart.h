@@ -0,0 +1,141 @@
+#pragma once
+
+/**
+ * \file
+ * \brief Synthetic Test Chart
+ *
+ * GDAL cannot author S57 cells with geometry, so a test chart is a
+ * placeholder cell file, with a chart store and metadata file already in
+ * the cache. With chart stores enabled, it is indexed from the metadata
+ * file and its features are read from the store, never parsing the cell.
+ */
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <filesystem>
+#include <fstream>
+#include <gdal_priv.h>
+#include <encdata/chart_store.h>
+#include <encdata/metadata_file.h>
+
+/**
+ * Add Synthetic Feature
+ *
+ * \param[out] layer Output layer
+ * \param[in] wkt Feature geometry
+ * \param[in] field Numeric field name (or nullptr)
+ * \param[in] value Numeric field value
+ */
+inline void add_synthetic_feature(OGRLayer *layer, const std::string &wkt,
+                                  const char *field = nullptr, double value = 0)
+{
+    OGRGeometry *geo = nullptr;
+    OGRGeometryFactory::createFromWkt(wkt.c_str(), nullptr, &geo);
+    OGRFeature *feat = OGRFeature::CreateFeature(layer->GetLayerDefn());
+    feat->SetGeometryDirectly(geo);
+    if (field != nullptr)
+    {
+        feat->SetField(field, value);
+    }
+    layer->CreateFeature(feat);
+    OGRFeature::DestroyFeature(feat);
+}
+
+/**
+ * Rectangle as WKT
+ *
+ * \param[in] x0,y0,x1,y1 Rectangle bounds (deg)
+ * \return Polygon WKT
+ */
+inline std::string synthetic_rect(double x0, double y0, double x1, double y1)
+{
+    std::string p0 = std::to_string(x0) + " " + std::to_string(y0);
+    return "POLYGON ((" + p0 + "," +
+        std::to_string(x1) + " " + std::to_string(y0) + "," +
+        std::to_string(x1) + " " + std::to_string(y1) + "," +
+        std::to_string(x0) + " " + std::to_string(y1) + "," + p0 + "))";
+}
+
+/**
+ * Write Synthetic Chart
+ *
+ * Covers the bounding box with depth areas (shallow west half, deeper east
+ * half), an island, and soundings.
+ *
+ * \param[in] chart_root Chart directory (ENC_ROOT)
+ * \param[in] cache_path Metadata cache directory
+ * \param[in] name Chart name
+ * \param[in] bbox Chart coverage (deg)
+ * \param[in] scale Compilation scale
+ * \return False on failure
+ */
+inline bool write_synthetic_chart(const std::filesystem::path &chart_root,
+                                  const std::filesystem::path &cache_path,
+                                  const std::string &name, const OGREnvelope &bbox,
+                                  int scale)
+{
+    // Placeholder cell, for its fingerprint
+    encdata::chart_metadata chart;
+    chart.path = chart_root / name / (name + ".000");
+    std::filesystem::create_directories(chart.path.parent_path());
+    std::ofstream(chart.path) << "synthetic chart " << name << "\n";
+    chart.file_size = std::filesystem::file_size(chart.path);
+    chart.file_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::filesystem::last_write_time(chart.path).time_since_epoch()).count();
+    chart.scale = scale;
+    chart.bbox = bbox;
+    chart.coverage = { bbox };
+    chart.store_version = encdata::chart_store::version;
+
+    // Chart contents
+    GDALAllRegister();
+    GDALDriver *drv = GetGDALDriverManager()->GetDriverByName(GDAL_MEM_DRIVER);
+    std::unique_ptr<GDALDataset> ds(drv->Create("", 0, 0, 0, GDT_Unknown, nullptr));
+    double mid_x = (bbox.MinX + bbox.MaxX) / 2;
+    double mid_y = (bbox.MinY + bbox.MaxY) / 2;
+    double step_x = (bbox.MaxX - bbox.MinX) / 8;
+    double step_y = (bbox.MaxY - bbox.MinY) / 8;
+
+    OGRLayer *layer = ds->CreateLayer("M_COVR");
+    OGRFieldDefn catcov("CATCOV", OFTInteger);
+    layer->CreateField(&catcov);
+    add_synthetic_feature(layer, synthetic_rect(bbox.MinX, bbox.MinY, bbox.MaxX, bbox.MaxY),
+                          "CATCOV", 1);
+
+    layer = ds->CreateLayer("DEPARE");
+    OGRFieldDefn drval1("DRVAL1", OFTReal);
+    layer->CreateField(&drval1);
+    add_synthetic_feature(layer, synthetic_rect(bbox.MinX, bbox.MinY, mid_x, bbox.MaxY),
+                          "DRVAL1", 2);
+    add_synthetic_feature(layer, synthetic_rect(mid_x, bbox.MinY, bbox.MaxX, bbox.MaxY),
+                          "DRVAL1", 10);
+
+    layer = ds->CreateLayer("LNDARE");
+    add_synthetic_feature(layer, synthetic_rect(mid_x - step_x, mid_y - step_y,
+                                                mid_x + step_x, mid_y + step_y));
+
+    layer = ds->CreateLayer("SOUNDG");
+    std::string soundings = "MULTIPOINT Z (";
+    for (int i = 1; i < 8; i++)
+    {
+        soundings += ((i > 1) ? "," : "") +
+            std::to_string(bbox.MinX + i * step_x) + " " +
+            std::to_string(bbox.MinY + step_y) + " " + std::to_string(i);
+    }
+    add_synthetic_feature(layer, soundings + ")");
+
+    // Coverage polygon for chart selection
+    OGRGeometry *area = nullptr;
+    std::string area_wkt = synthetic_rect(bbox.MinX, bbox.MinY, bbox.MaxX, bbox.MaxY);
+    OGRGeometryFactory::createFromWkt(area_wkt.c_str(), nullptr, &area);
+    chart.coverage_wkb.resize(area->WkbSize());
+    area->exportToWkb(wkbNDR, chart.coverage_wkb.data());
+    OGRGeometryFactory::destroyGeometry(area);
+
+    // Store and metadata, as indexing would leave them
+    std::filesystem::path store_path = cache_path / "store" / (name + ".bin");
+    std::filesystem::create_directories(store_path.parent_path());
+    return encdata::chart_store::write(store_path, chart, ds.get()) &&
+        encdata::metadata_file::write(cache_path / "charts.idx", { &chart });
+}
@@ -0,0 +1,97 @@
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <encviz/enc_renderer.h>
+#include "../encdata/synthetic_chart.h"
+using namespace testing;
+using namespace encviz;
+
+static OGREnvelope make_bbox(double x0, double y0, double x1, double y1)
+{
+    OGREnvelope bbox;
+    bbox.MinX = x0;
+    bbox.MinY = y0;
+    bbox.MaxX = x1;
+    bbox.MaxY = y1;
+    return bbox;
+}
+
+// Build with -DENABLE_TSAN=ON to check for data races
+TEST(enc_renderer, concurrent_render)
+{
+    // Small scale chart, read from its chart store, with the standard
+    // themes and styles
+    std::filesystem::path root = std::filesystem::temp_directory_path() /
+        ("enc_renderer_test." + std::to_string(getpid()));
+    ASSERT_TRUE(write_synthetic_chart(root / "charts", root / "meta", "TEST0001",
+                                      make_bbox(20, 20, 30, 30), 50000000));
+    std::ofstream(root / "config.xml") <<
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<enctools>\n"
+        "  <chart_path>charts</chart_path>\n"
+        "  <meta_path>meta</meta_path>\n"
+        "  <chart_store>true</chart_store>\n"
+        "  <theme_file>" ENCTOOLS_CONFIG_DIR "/color-table.xml</theme_file>\n"
+        "  <style_path>" ENCTOOLS_CONFIG_DIR "/styles</style_path>\n"
+        "  <tile_size>256</tile_size>\n"
+        "  <scale_base>5e8</scale_base>\n"
+        "</enctools>\n";
+    enc_renderer renderer(root.c_str());
+
+    // Tiles over the chart (WMTS x, y, z), and one without any data
+    const std::vector<std::tuple<int, int, int>> tiles = {
+        { 9, 6, 4 }, { 17, 13, 5 }, { 18, 13, 5 }, { 0, 0, 4 },
+    };
+    const std::vector<const char*> style_names = { "base-day", "standard-night" };
+
+    // Single threaded reference tiles, by tile and style index
+    typedef std::pair<std::size_t, std::size_t> tile_style;
+    std::map<tile_style, std::vector<uint8_t>> expected;
+    for (std::size_t i = 0; i < tiles.size(); i++)
+    {
+        for (std::size_t j = 0; j < style_names.size(); j++)
+        {
+            auto [x, y, z] = tiles[i];
+            std::vector<uint8_t> &data = expected[tile_style(i, j)];
+            ASSERT_TRUE(renderer.render(data, tile_coords::WTMS, x, y, z, style_names[j]));
+            ASSERT_FALSE(data.empty());
+        }
+    }
+    ASSERT_NE(expected[tile_style(0, 0)], expected[tile_style(3, 0)]);
+
+    // Each thread cycles through tiles and styles, reusing its own buffers,
+    // and must match the reference exactly
+    const int thread_count = 8;
+    const int iterations = 40;
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++)
+    {
+        threads.emplace_back([&, t]() {
+            std::vector<uint8_t> data;
+            for (int n = 0; n < iterations; n++)
+            {
+                std::size_t i = (t + n) % tiles.size();
+                std::size_t j = (t + n / tiles.size()) % style_names.size();
+                auto [x, y, z] = tiles[i];
+                if (!renderer.render(data, tile_coords::WTMS, x, y, z, style_names[j]) ||
+                    (data != expected.at(tile_style(i, j))))
+                {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    std::filesystem::remove_all(root);
+
+    ASSERT_EQ(failures, 0);
+}
@@ -0,0 +1,118 @@
+#include <cstring>
+#include <gtest/gtest.h>
+#include <png.h>
+#include <encviz/png_encoder.h>
+using namespace testing;
+using namespace encviz;
+
+// Decode PNG to straight RGBA
+static bool decode_rgba(const std::vector<uint8_t> &data, std::vector<uint8_t> &rgba,
+                        int &width, int &height)
+{
+    png_image image;
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_memory(&image, data.data(), data.size()))
+    {
+        return false;
+    }
+    image.format = PNG_FORMAT_RGBA;
+    width = image.width;
+    height = image.height;
+    rgba.resize(PNG_IMAGE_SIZE(image));
+    return png_image_finish_read(&image, nullptr, rgba.data(), 0, nullptr);
+}
+
+TEST(png_encoder, opaque)
+{
+    // Flat tile, with one stripe
+    const int size = 64;
+    std::vector<uint32_t> pixels(size * size, 0xff336699);
+    for (int x = 0; x < size; x++)
+    {
+        pixels[10 * size + x] = 0xff000000;
+    }
+
+    png_options opts;
+    opts.level = 1;
+    opts.filter = png_options::FILTER_UP;
+    opts.strategy = png_options::STRATEGY_RLE;
+    std::vector<uint8_t> data;
+    ASSERT_TRUE(png_encoder(opts).encode(data, pixels.data(), size, size));
+    ASSERT_LT(data.size(), pixels.size());
+
+    std::vector<uint8_t> rgba;
+    int width, height;
+    ASSERT_TRUE(decode_rgba(data, rgba, width, height));
+    ASSERT_EQ(width, size);
+    ASSERT_EQ(height, size);
+    ASSERT_EQ(rgba[0], 0x33);
+    ASSERT_EQ(rgba[1], 0x66);
+    ASSERT_EQ(rgba[2], 0x99);
+    ASSERT_EQ(rgba[3], 0xff);
+    ASSERT_EQ(rgba[(10 * size + 5) * 4], 0x00);
+}
+
+TEST(png_encoder, translucent)
+{
+    // Premultiplied half transparent white, and fully transparent
+    std::vector<uint32_t> pixels = { 0x80808080, 0x00000000 };
+    std::vector<uint8_t> data;
+    ASSERT_TRUE(png_encoder().encode(data, pixels.data(), 2, 1));
+
+    std::vector<uint8_t> rgba;
+    int width, height;
+    ASSERT_TRUE(decode_rgba(data, rgba, width, height));
+    ASSERT_EQ(rgba[0], 0xff);
+    ASSERT_EQ(rgba[3], 0x80);
+    ASSERT_EQ(rgba[7], 0x00);
+}
+
+TEST(png_encoder, parse)
+{
+    int level = 0;
+    ASSERT_TRUE(png_options::parse_level("9", level));
+    ASSERT_EQ(level, 9);
+    ASSERT_FALSE(png_options::parse_level("10", level));
+    ASSERT_FALSE(png_options::parse_level("-1", level));
+    ASSERT_FALSE(png_options::parse_level("fast", level));
+    ASSERT_FALSE(png_options::parse_level("", level));
+
+    png_options::filter_type filter;
+    ASSERT_TRUE(png_options::parse_filter("paeth", filter));
+    ASSERT_EQ(filter, png_options::FILTER_PAETH);
+    ASSERT_FALSE(png_options::parse_filter("best", filter));
+
+    png_options::strategy_type strategy;
+    ASSERT_TRUE(png_options::parse_strategy("rle", strategy));
+    ASSERT_EQ(strategy, png_options::STRATEGY_RLE);
+    ASSERT_FALSE(png_options::parse_strategy("fast", strategy));
+}
+
+TEST(png_encoder, indexed)
+{
+    color_palette palette;
+    color blue;
+    blue.alpha = 0xff;
+    blue.blue = 0xc0;
+    ASSERT_TRUE(palette.add(blue));
+    ASSERT_EQ(palette.size(), 2);
+
+    // Transparent, blue, and nearly blue (as a blended edge would be)
+    std::vector<uint32_t> pixels = { 0x00000000, 0xff0000c0, 0xff0101bf };
+    std::vector<uint8_t> indexes;
+    palette.quantize(indexes, pixels.data(), pixels.size());
+    ASSERT_EQ(indexes, std::vector<uint8_t>({ 0, 1, 1 }));
+
+    std::vector<uint8_t> data;
+    ASSERT_TRUE(png_encoder().encode_indexed(data, indexes.data(), 3, 1, palette));
+
+    std::vector<uint8_t> rgba;
+    int width, height;
+    ASSERT_TRUE(decode_rgba(data, rgba, width, height));
+    ASSERT_EQ(width, 3);
+    ASSERT_EQ(rgba[3], 0x00);
+    ASSERT_EQ(rgba[6], 0xc0);
+    ASSERT_EQ(rgba[7], 0xff);
+    ASSERT_EQ(rgba[10], 0xc0);
+}
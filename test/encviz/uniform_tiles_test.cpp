@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include <encviz/uniform_tiles.h>
+using namespace testing;
+using namespace encviz;
+
+TEST(uniform_tiles, detect)
+{
+    std::vector<uint32_t> pixels(256 * 256, 0xff336699);
+    uint32_t pixel = 0;
+    ASSERT_TRUE(uniform_tiles::is_uniform(pixels.data(), pixels.size(), pixel));
+    ASSERT_EQ(pixel, 0xff336699);
+
+    // One differing pixel, at the very end
+    pixels.back() = 0xff000000;
+    ASSERT_FALSE(uniform_tiles::is_uniform(pixels.data(), pixels.size(), pixel));
+}
+
+TEST(uniform_tiles, table)
+{
+    uniform_tiles table(2);
+    std::vector<uint8_t> data;
+    ASSERT_FALSE(table.find(data, 0, 0xff336699));
+
+    // Same color kept separately per format
+    table.insert({ 1, 2, 3 }, 0, 0xff336699);
+    table.insert({ 4, 5 }, 1, 0xff336699);
+    ASSERT_TRUE(table.find(data, 0, 0xff336699));
+    ASSERT_EQ(data, std::vector<uint8_t>({ 1, 2, 3 }));
+    ASSERT_TRUE(table.find(data, 1, 0xff336699));
+    ASSERT_EQ(data, std::vector<uint8_t>({ 4, 5 }));
+
+    // Full, so no more entries added
+    table.insert({ 6 }, 0, 0xff000000);
+    ASSERT_EQ(table.size(), 2);
+    ASSERT_FALSE(table.find(data, 0, 0xff000000));
+}
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <vector>
 #include <gtest/gtest.h>
 #include <encviz/web_mercator.h>
@@ -88,3 +90,41 @@ TEST(web_mercator, testcases)
 	}
     }
 }
+
+TEST(web_mercator, bulk_deg_to_pixels)
+{
+    // Grid of coordinates, including both sides of the equator and poles
+    std::vector<double> x, y;
+    for (double lat = -90; lat <= 90; lat += 0.37)
+    {
+        for (double lon = -180; lon <= 180; lon += 7.3)
+        {
+            x.push_back(lon);
+            y.push_back(lat);
+        }
+    }
+    x.push_back(-80.125);
+    y.push_back(0);
+
+    // Bulk path matches scalar path, from world tile down to street level
+    for (std::size_t z : { 0, 5, 12, 20 })
+    {
+        std::size_t n = (1UL << z) / 3;
+        web_mercator wm(n, n, z);
+        std::vector<double> px(x.size()), py(x.size());
+        wm.deg_to_pixels(x.data(), y.data(), x.size(), px.data(), py.data());
+        for (std::size_t i = 0; i < x.size(); i++)
+        {
+            if (std::fabs(y[i]) > 85.06)
+            {
+                // Outside of Web Mercator, only check that it's finite
+                ASSERT_TRUE(std::isfinite(py[i]));
+                continue;
+            }
+            coord c = wm.deg_to_pixels({ x[i], y[i] });
+            double tol = 1e-6 + 1e-12 * std::max(std::fabs(c.x), std::fabs(c.y));
+            ASSERT_NEAR(px[i], c.x, tol) << "lon=" << x[i] << " z=" << z;
+            ASSERT_NEAR(py[i], c.y, tol) << "lat=" << y[i] << " z=" << z;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#ifdef HAVE_WEBP
+#include <webp/decode.h>
+#endif
+#include <encviz/webp_encoder.h>
+using namespace testing;
+using namespace encviz;
+
+TEST(webp_encoder, lossless)
+{
+    if (!webp_encoder::available())
+    {
+        GTEST_SKIP() << "Built without libwebp";
+    }
+
+    // Flat tile, with one stripe, and one half transparent white pixel
+    const int size = 64;
+    std::vector<uint32_t> pixels(size * size, 0xff336699);
+    for (int x = 0; x < size; x++)
+    {
+        pixels[10 * size + x] = 0xff000000;
+    }
+    pixels[0] = 0x80808080;
+
+    std::vector<uint8_t> data;
+    ASSERT_TRUE(webp_encoder(0).encode(data, pixels.data(), size, size));
+    ASSERT_LT(data.size(), pixels.size());
+
+#ifdef HAVE_WEBP
+    int width, height;
+    uint8_t *rgba = WebPDecodeRGBA(data.data(), data.size(), &width, &height);
+    ASSERT_NE(rgba, nullptr);
+    ASSERT_EQ(width, size);
+    ASSERT_EQ(height, size);
+    EXPECT_EQ(rgba[0], 0xff);
+    EXPECT_EQ(rgba[3], 0x80);
+    EXPECT_EQ(rgba[4], 0x33);
+    EXPECT_EQ(rgba[5], 0x66);
+    EXPECT_EQ(rgba[6], 0x99);
+    EXPECT_EQ(rgba[(10 * size + 5) * 4], 0x00);
+    WebPFree(rgba);
+#endif
+}